@@ -0,0 +1,309 @@
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include <cstdio>
+#include <string>
+
+#ifdef ASTEROIDS_TRACK_ALLOCATIONS
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+#include "AllocationTracker.h"
+
+using namespace std;
+using namespace asteroids;
+
+/** The number of return addresses that identify a call stack */
+static constexpr int kSiteFrames = 6;
+
+/** The number of call stacks that can be told apart, a power of two */
+static constexpr int kSiteCount = 4096;
+
+/** The allocations made from one call stack */
+struct Site {
+  /** A hash of the call stack, 0 while the slot is free */
+  atomic<uint64_t> hash;
+
+  /** The return addresses of the call stack, innermost first */
+  void* frames[kSiteFrames];
+
+  /** The number of allocations */
+  atomic<uint64_t> allocations;
+
+  /** The number of bytes allocated */
+  atomic<uint64_t> bytes;
+};
+
+/** The allocations counted against each phase */
+static atomic<uint64_t> phaseAllocations[AllocationTracker::kPhaseCount];
+
+/** The bytes counted against each phase */
+static atomic<uint64_t> phaseBytes[AllocationTracker::kPhaseCount];
+
+/** The call stacks which allocated while in a phase */
+static Site sites[kSiteCount];
+
+/** The allocations made by the current tick */
+static atomic<uint64_t> tickAllocations;
+
+/** The most allocations a tick may make, -1 for no limit */
+static atomic<long long> budget{-1};
+
+/** The number of ticks which went over the budget */
+static atomic<uint64_t> overBudget;
+
+/** The most allocations made by a single tick */
+static atomic<uint64_t> worst;
+
+/** The phase the thread is counting against */
+static thread_local AllocationTracker::Phase currentPhase = AllocationTracker::PhaseNone;
+
+#ifdef ASTEROIDS_TRACK_ALLOCATIONS
+/** Whether the thread is already inside the hook, so the hook's own allocations are not counted */
+static thread_local bool inHook = false;
+
+/**
+ * Counts an allocation against the thread's phase and the call stack it came from.
+ */
+static void count(/** The size of the allocation */size_t size) noexcept {
+  if (inHook) {
+    return;
+  }
+  inHook = true;
+
+  AllocationTracker::Phase phase = currentPhase;
+  phaseAllocations[phase].fetch_add(1, memory_order_relaxed);
+  phaseBytes[phase].fetch_add(size, memory_order_relaxed);
+  if (phase == AllocationTracker::PhaseSpawn || phase == AllocationTracker::PhaseMove || phase == AllocationTracker::PhaseCollide) {
+    tickAllocations.fetch_add(1, memory_order_relaxed);
+  }
+
+  //Only allocations made inside a phase are worth the cost of a backtrace
+  if (phase != AllocationTracker::PhaseNone) {
+    //Skips this function and operator new itself
+    void* frames[kSiteFrames + 2] = {};
+    int depth = backtrace(frames, kSiteFrames + 2);
+    uint64_t hash = 1469598103934665603ull;
+    for (int i = 2; i < depth; i++) {
+      hash = (hash ^ (uintptr_t) frames[i]) * 1099511628211ull;
+    }
+    hash |= 1;
+
+    //Finds or claims the call stack's slot by linear probing, a full table
+    //just stops attributing
+    for (int probe = 0; probe < kSiteCount; probe++) {
+      Site& site = sites[(hash + probe) & (kSiteCount - 1)];
+      uint64_t expected = 0;
+      if (site.hash.compare_exchange_strong(expected, hash, memory_order_acq_rel)) {
+        copy(frames + 2, frames + kSiteFrames + 2, site.frames);
+      }
+      else if (expected != hash) {
+        continue;
+      }
+      site.allocations.fetch_add(1, memory_order_relaxed);
+      site.bytes.fetch_add(size, memory_order_relaxed);
+      break;
+    }
+  }
+
+  inHook = false;
+}
+
+/**
+ * Names the function a return address is in, demangled, along with how far
+ * into it the address is. Functions the dynamic linker cannot see, such as
+ * static ones or any in a build without -rdynamic, are given as the module
+ * and offset instead, which addr2line -f -C -e turns into a function and line.
+ *
+ * @returns the name of the address.
+ */
+static string symbolize(/** The return address */void* address) {
+  char offset[32];
+  Dl_info info;
+  if (!dladdr(address, &info) || !info.dli_fname) {
+    snprintf(offset, sizeof(offset), "%p", address);
+    return offset;
+  }
+  if (info.dli_sname) {
+    int status = -1;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    string name = status == 0 ? demangled : info.dli_sname;
+    free(demangled);
+    snprintf(offset, sizeof(offset), "+0x%lx", (unsigned long) ((char*) address - (char*) info.dli_saddr));
+    return name + offset + " (" + info.dli_fname + ")";
+  }
+  snprintf(offset, sizeof(offset), "+0x%lx", (unsigned long) ((char*) address - (char*) info.dli_fbase));
+  return string(info.dli_fname) + offset;
+}
+
+/**
+ * Allocates and counts memory for operator new.
+ */
+static void* allocate(/** The size of the allocation */size_t size, /** The alignment, 0 for the default */size_t alignment) {
+  count(size);
+  void* memory = alignment == 0 ? malloc(max<size_t>(size, 1)) : aligned_alloc(alignment, (max<size_t>(size, 1) + alignment - 1) / alignment * alignment);
+  if (!memory) {
+    throw bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new(size_t size) {
+  return allocate(size, 0);
+}
+
+void* operator new[](size_t size) {
+  return allocate(size, 0);
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+  return allocate(size, (size_t) alignment);
+}
+
+void* operator new[](size_t size, align_val_t alignment) {
+  return allocate(size, (size_t) alignment);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+  try {
+    return allocate(size, 0);
+  }
+  catch (const bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+  try {
+    return allocate(size, 0);
+  }
+  catch (const bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* memory) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory, align_val_t) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+  free(memory);
+}
+
+void operator delete[](void* memory, size_t, align_val_t) noexcept {
+  free(memory);
+}
+#endif
+
+void AllocationTracker::setBudget(long long perTick) noexcept {
+  //Sets the limit checked at the end of every tick
+  budget = perTick;
+}
+
+void AllocationTracker::beginTick() noexcept {
+  //Starts the tick's count from nothing
+  tickAllocations.store(0, memory_order_relaxed);
+}
+
+bool AllocationTracker::endTick() noexcept {
+  //Remembers the worst tick and whether this one went over the budget
+  uint64_t made = tickAllocations.load(memory_order_relaxed);
+  if (made > worst.load(memory_order_relaxed)) {
+    worst.store(made, memory_order_relaxed);
+  }
+  long long limit = budget.load(memory_order_relaxed);
+  if (limit >= 0 && made > (uint64_t) limit) {
+    overBudget.fetch_add(1, memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+uint64_t AllocationTracker::overBudgetTicks() noexcept {
+  //Returns the ticks over the budget
+  return overBudget.load(memory_order_relaxed);
+}
+
+uint64_t AllocationTracker::worstTick() noexcept {
+  //Returns the worst tick
+  return worst.load(memory_order_relaxed);
+}
+
+AllocationTracker::Counts AllocationTracker::counts(Phase phase) noexcept {
+  //Returns the counts of the phase
+  return Counts{phaseAllocations[phase].load(memory_order_relaxed), phaseBytes[phase].load(memory_order_relaxed)};
+}
+
+AllocationTracker::Counts AllocationTracker::simulationCounts() noexcept {
+  //Adds up the phases a tick runs in
+  Counts total = {0, 0};
+  for (Phase phase : {PhaseSpawn, PhaseMove, PhaseCollide, PhaseReserve}) {
+    Counts phaseCounts = counts(phase);
+    total.allocations += phaseCounts.allocations;
+    total.bytes += phaseCounts.bytes;
+  }
+  return total;
+}
+
+void AllocationTracker::report(ostream& out) {
+  if (!kEnabled) {
+    out << "allocations are not tracked in this build" << endl;
+    return;
+  }
+
+  static const char* const names[kPhaseCount] = {"none", "spawn", "move", "collide", "render", "network", "reserve"};
+  for (int phase = 0; phase < kPhaseCount; phase++) {
+    Counts phaseCounts = counts((Phase) phase);
+    out << names[phase] << ": " << phaseCounts.allocations << " allocations, " << phaseCounts.bytes << " bytes" << endl;
+  }
+  out << "worst tick: " << worstTick() << " allocations, " << overBudgetTicks() << " ticks over budget" << endl;
+
+  //Lists the call stacks which allocated most often, innermost frame first
+  vector<const Site*> busiest;
+  for (const Site& site : sites) {
+    if (site.allocations.load(memory_order_relaxed) != 0) {
+      busiest.push_back(&site);
+    }
+  }
+  sort(busiest.begin(), busiest.end(), [](const Site* a, const Site* b) { return a->allocations > b->allocations; });
+  busiest.resize(min<size_t>(busiest.size(), 10));
+  for (const Site* site : busiest) {
+    out << site->allocations << " allocations, " << site->bytes << " bytes from:" << endl;
+#ifdef ASTEROIDS_TRACK_ALLOCATIONS
+    for (int i = 0; i < kSiteFrames && site->frames[i]; i++) {
+      out << "  " << symbolize(site->frames[i]) << endl;
+    }
+#endif
+  }
+}
+
+AllocationTracker::Phase AllocationTracker::enter(Phase phase) noexcept {
+  //Swaps in the new phase and hands back the old one
+  Phase previous = currentPhase;
+  currentPhase = phase;
+  return previous;
+}
@@ -0,0 +1,157 @@
+#ifndef ASTEROIDS_ALLOCATIONTRACKER_H
+#define ASTEROIDS_ALLOCATIONTRACKER_H
+
+#include <cstdint>
+#include <ostream>
+
+namespace asteroids {
+
+/**
+ * Counts every heap allocation the game makes, by the phase of the tick or
+ * frame it was made in and by the call stack it was made from, and checks
+ * each simulation tick against an allocation budget.
+ *
+ * Counting replaces the global operator new, so it only happens in
+ * instrumented builds, which define ASTEROIDS_TRACK_ALLOCATIONS. Other builds
+ * keep the same interface but count nothing, and the phase scopes compile
+ * away entirely.
+ *
+ * @author Jai Aslam
+ */
+class AllocationTracker {
+public:
+  /** The parts of a tick or frame allocations are counted against */
+  enum Phase {
+    /** Outside any tracked phase, counted but never against the budget */
+    PhaseNone,
+
+    /** Spawning the asteroids of a wave */
+    PhaseSpawn,
+
+    /** Moving the asteroids, bullets and particles */
+    PhaseMove,
+
+    /** Checking for collisions and breaking up asteroids */
+    PhaseCollide,
+
+    /** Drawing a frame */
+    PhaseRender,
+
+    /** Sending and receiving over the network */
+    PhaseNetwork,
+
+    /** Making room up front for everything a level can grow to, counted but never against the budget */
+    PhaseReserve,
+
+    /** The number of phases */
+    kPhaseCount
+  };
+
+  /** The allocations counted against one phase */
+  struct Counts {
+    /** The number of allocations */
+    std::uint64_t allocations;
+
+    /** The number of bytes allocated */
+    std::uint64_t bytes;
+  };
+
+  /** Whether this build counts allocations at all */
+#ifdef ASTEROIDS_TRACK_ALLOCATIONS
+  static constexpr bool kEnabled = true;
+#else
+  static constexpr bool kEnabled = false;
+#endif
+
+  /**
+  * Sets the most allocations a simulation tick may make, -1 for no limit.
+  */
+  static void setBudget(/** The allocations allowed per tick */long long perTick) noexcept;
+
+  /**
+  * Starts counting the allocations of a simulation tick.
+  */
+  static void beginTick() noexcept;
+
+  /**
+  * Finishes counting the allocations of a simulation tick.
+  *
+  * @returns whether the tick stayed within the budget.
+  */
+  static bool endTick() noexcept;
+
+  /**
+  * @returns the number of ticks which went over the budget.
+  */
+  static std::uint64_t overBudgetTicks() noexcept;
+
+  /**
+  * @returns the most allocations made by a single tick.
+  */
+  static std::uint64_t worstTick() noexcept;
+
+  /**
+  * @returns the allocations counted against the given phase.
+  */
+  static Counts counts(/** The phase */Phase phase) noexcept;
+
+  /**
+  * @returns the allocations counted against the phases of the simulation,
+  * including the room made up front for each level.
+  */
+  static Counts simulationCounts() noexcept;
+
+  /**
+  * Prints the allocations of each phase and the call stacks which allocated
+  * the most while in a phase, named by function where the executable was
+  * linked with -rdynamic and by module and offset otherwise.
+  */
+  static void report(/** Where to print the report */std::ostream& out);
+
+  /**
+  * Makes the calling thread count its allocations against the given phase.
+  *
+  * @returns the phase the thread was in before.
+  */
+  static Phase enter(/** The phase to count against */Phase phase) noexcept;
+};
+
+/**
+ * Counts the allocations made by the calling thread against a phase for as
+ * long as the scope lasts. Costs nothing unless allocations are tracked.
+ *
+ * @author Jai Aslam
+ */
+class AllocationScope {
+public:
+#ifdef ASTEROIDS_TRACK_ALLOCATIONS
+  /**
+  * Enters the given phase.
+  */
+  explicit AllocationScope(/** The phase to count against */AllocationTracker::Phase phase) noexcept
+    : previous_(AllocationTracker::enter(phase)) {}
+
+  /**
+  * Goes back to the phase the thread was in before.
+  */
+  ~AllocationScope() {
+    AllocationTracker::enter(previous_);
+  }
+
+private:
+  /** The phase the thread was in before */
+  AllocationTracker::Phase previous_;
+#else
+  /**
+  * Does nothing, allocations are not tracked.
+  */
+  explicit AllocationScope(/** The phase to count against */AllocationTracker::Phase) noexcept {}
+#endif
+
+public:
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+};
+}
+
+#endif
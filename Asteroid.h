@@ -2,6 +2,9 @@
 #define ASTEROIDS_ASTEROID_H
 
 #include "Bullet.h"
+#include "Fixed.h"
+#include "MeshLibrary.h"
+#include "LineBatch.h"
 #include <memory>
 
 namespace asteroids {
@@ -45,6 +48,16 @@ public:
   */
   int getDirection() const noexcept;
 
+  /**
+  * @returns the current position of the asteroid to a fraction of a pixel.
+  */
+  const FixedVector& getPosition() const noexcept;
+
+  /**
+  * @returns the unit vector pointing in the direction of travel.
+  */
+  const FixedVector& getHeading() const noexcept;
+
   /**
   * Updates the current position of the given
   * the magnitude of the velocity vector.   
@@ -54,31 +67,28 @@ public:
   /**
   * Checks if the given bullet collides with the asteroid. 
   */
-  bool collides(/** The given bullet */ std::shared_ptr<Bullet> bullet) const noexcept;
+  bool collides(/** The given bullet */ const Bullet& bullet) const noexcept;
 
   /**
-  * Draws the ship from its current position.
+  * Adds the outline of the asteroid at its current position to the batch.
   */ 
-  void draw(/** The renderer which draws the asteroid */ SDL_Renderer* r) noexcept;
+  void draw(/** The batch the outline is added to */ LineBatch& batch) const;
 
 private:
-  /** The current x coordinate of the asteroid. */
-  int x_;
- 
-  /** The current y coordinate of the asteroid. */
-  int y_;
+  /** The current position of the asteroid. */
+  FixedVector position_;
 
   /** The radius of the asteroid. */
   int radius_;
 
-  /** The direction in degrees that the asteroid is traveling in. */
+  /** The direction in radians that the asteroid is traveling in. */
   int direction_;
 
-  /**
-  * Rotates the given point about the center point by the angle the asteroid
-  * is facing.
-  */
-  SDL_Point rotateAboutCenter(/** X coordinate of point */ int pointX, /** Y coordinate of point */ int pointY, /** Angle of rotation */ int angle);
+  /** The unit vector pointing in the direction the asteroid is traveling in. */
+  FixedVector heading_;
+
+  /** The outline the asteroid is drawn with, shared with other asteroids */
+  const AsteroidMesh* mesh_;
 
   /**
   * Makes the ship wrap around if it goes off the edge of the screen.
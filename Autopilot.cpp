@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "Autopilot.h"
+#include "Collision.h"
+#include "Game.h"
+
+using namespace std;
+using namespace asteroids;
+
+Autopilot::Autopilot(int asteroidStep, int shipSize) noexcept : asteroidStep_(asteroidStep), shipSize_(shipSize) {}
+
+Autopilot::~Autopilot() {}
+
+unsigned Autopilot::decide(const Game& game) noexcept {
+  //Flies the player's ship
+  return decide(game.getPlayer(), game.getAsteroidIndex());
+}
+
+unsigned Autopilot::decide(const Ship& ship, const SpatialGrid& index) noexcept {
+  const vector<Asteroid>& asteroids = index.asteroids();
+
+  //Only the asteroids close enough to reach the ship can hit it any time
+  //soon, which is further away the coarser the ticks. The buffer has room
+  //for every asteroid so none of them is left out, and the level already
+  //reserved it
+  threats_.resize(asteroids.size());
+  int* threats = threats_.data();
+  int count = index.query(ship.getX(), ship.getY(), kThreatMargin + asteroidStep_ * kDodgeTicks, threats, (int) threats_.size());
+
+  //Dodges by moving forwards or backwards, whichever puts off the next hit longest
+  unsigned action = ActionFire;
+  int soonest = ticksUntilHit(index, threats, count, ship.getPosition());
+  if (soonest <= kDodgeTicks) {
+    for (int step : {10, -10}) {
+      int ticks = ticksUntilHit(index, threats, count, ship.getPosition() + unitVector(ship.getAngle()) * step);
+      if (ticks > soonest) {
+        soonest = ticks;
+        action = ActionFire | (step > 0 ? ActionThrust : ActionReverse);
+      }
+    }
+  }
+
+  //Turns towards whichever of the nearest asteroids the ship is already
+  //closest to facing. That is the largest cosine between the heading and
+  //the way to the asteroid, compared squared with its sign kept, which
+  //orders the same without any square roots. The heading is cut to 8
+  //fraction bits so the products fit in 64 bits
+  int targets[kTargets];
+  int found = index.nearest(ship.getX(), ship.getY(), kTargets, targets);
+  int64_t bestSquare = -1;
+  int64_t bestDistance = 0;
+  int bestTurn = 0;
+  for (int i = 0; i < found; i++) {
+    const Asteroid& target = asteroids[targets[i]];
+    int64_t dx = target.getX() - ship.getX();
+    int64_t dy = target.getY() - ship.getY();
+    int64_t distance = dx * dx + dy * dy;
+    if (distance == 0) {
+      continue;
+    }
+    for (int turn : {0, -1, 1}) {
+      //The ship's angle wraps the same way updateAngle wraps it
+      FixedVector heading = unitVector((ship.getAngle() + turn) % 6);
+      int64_t dot = (heading.x.raw >> 8) * dx + (heading.y.raw >> 8) * dy;
+      int64_t square = dot >= 0 ? dot * dot : -dot * dot;
+      if (square * bestDistance > bestSquare * distance) {
+        bestSquare = square;
+        bestDistance = distance;
+        bestTurn = turn;
+      }
+    }
+  }
+  if (bestTurn < 0) {
+    action |= ActionRotateLeft;
+  }
+  else if (bestTurn > 0) {
+    action |= ActionRotateRight;
+  }
+  return action;
+}
+
+void Autopilot::reserve(int asteroids) noexcept {
+  //Keeps looking for threats from growing the list
+  threats_.reserve(asteroids);
+}
+
+int Autopilot::ticksUntilHit(const SpatialGrid& index, const int* threats, int count, FixedVector position) const noexcept {
+  const vector<Asteroid>& asteroids = index.asteroids();
+  int soonest = kDodgeTicks + 1;
+  for (int i = 0; i < count; i++) {
+    //The ship is treated as standing still, so the asteroid's path over the
+    //ticks looked ahead is swept against the ship the same way the game
+    //sweeps collisions
+    const Asteroid& ast = asteroids[threats[i]];
+    FixedVector start = ast.getPosition() - position;
+    FixedVector end = start + ast.getHeading() * (asteroidStep_ * kDodgeTicks);
+    int time = timeOfImpact(start, end, ast.getRadius() + shipSize_);
+    if (time >= 0) {
+      soonest = min(soonest, time * kDodgeTicks / kTickSteps);
+    }
+  }
+  return soonest;
+}
@@ -0,0 +1,85 @@
+#ifndef ASTEROIDS_AUTOPILOT_H
+#define ASTEROIDS_AUTOPILOT_H
+
+#include <vector>
+
+#include "Fixed.h"
+
+namespace asteroids {
+
+class Game;
+class Ship;
+class SpatialGrid;
+
+/**
+ * Flies the ship for load testing. The autopilot fires every tick, turns
+ * towards the nearest asteroids and moves out of the way of any asteroid
+ * that is about to hit the ship. It only ever looks at the asteroids near
+ * the ship through the game's spatial index, so its own cost barely grows
+ * with the number of asteroids. Like the rest of the simulation it only
+ * uses integer and fixed point arithmetic, so the same game flies the same
+ * way on every platform.
+ *
+ * @author Jai Aslam
+ */
+class Autopilot {
+public:
+  /**
+  * Constructs an autopilot for a game whose asteroids move the given
+  * distance each tick and whose ships are the given size.
+  */
+  Autopilot(/** How far an asteroid moves each tick */int asteroidStep, /** The distance from the center of a ship to its front */int shipSize) noexcept;
+
+  /**
+  * Destructs the autopilot.
+  */
+  ~Autopilot();
+
+  /**
+  * Picks what the ship should do this tick.
+  *
+  * @returns a combination of Action flags.
+  */
+  unsigned decide(/** The game being played */const Game& game) noexcept;
+
+  /**
+  * Picks what the given ship should do this tick, for flying ships other
+  * than the player's.
+  *
+  * @returns a combination of Action flags.
+  */
+  unsigned decide(/** The ship being flown */const Ship& ship, /** The index of the asteroids the ship shares the screen with */const SpatialGrid& index) noexcept;
+
+  /**
+  * Makes room to check against the given number of asteroids.
+  */
+  void reserve(/** The number of asteroids */int asteroids) noexcept;
+
+private:
+  /** How many of the nearest asteroids are considered as targets */
+  static constexpr int kTargets = 4;
+
+  /** How much further than an asteroid moves while the autopilot looks ahead asteroids are checked for collisions */
+  static constexpr int kThreatMargin = 70;
+
+  /** How many ticks ahead a collision has to be before the ship dodges it */
+  static constexpr int kDodgeTicks = 25;
+
+  /** How far an asteroid moves each tick */
+  const int asteroidStep_;
+
+  /** The distance from the center of a ship to its front */
+  const int shipSize_;
+
+  /** The asteroids close enough to hit the ship soon, with room for every asteroid */
+  std::vector<int> threats_;
+
+  /**
+  * @returns how many ticks until the nearest of the given asteroids hits a
+  * ship at the given position, or kDodgeTicks + 1 if none hit soon.
+  */
+  int ticksUntilHit(/** The asteroid index */const SpatialGrid& index, /** The asteroids near the ship */const int* threats, /** The number of asteroids near the ship */int count, /** The position of the ship */FixedVector position) const noexcept;
+};
+}
+
+#endif
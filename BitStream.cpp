@@ -0,0 +1,77 @@
+#include <cstring>
+#include <algorithm>
+
+#include "BitStream.h"
+
+using namespace std;
+using namespace asteroids;
+
+BitWriter::BitWriter(uint8_t* buffer, int capacity) noexcept
+  : buffer_(buffer), capacityBits_(capacity * 8) {
+  //Bits are ORed in, so the buffer has to start out clear
+  memset(buffer_, 0, capacity);
+}
+
+void BitWriter::write(uint32_t value, int bits) noexcept {
+  patch(position_, value, bits);
+  position_ += bits;
+}
+
+void BitWriter::patch(int position, uint32_t value, int bits) noexcept {
+  if (position + bits > capacityBits_) {
+    overflowed_ = true;
+    return;
+  }
+
+  //Writes the bits lowest first, a byte's worth at a time where possible
+  for (int done = 0; done < bits;) {
+    int bit = position + done;
+    int chunk = min(bits - done, 8 - bit % 8);
+    uint8_t mask = ((1u << chunk) - 1) << (bit % 8);
+    uint8_t piece = ((value >> done) << (bit % 8)) & mask;
+    buffer_[bit / 8] = (buffer_[bit / 8] & ~mask) | piece;
+    done += chunk;
+  }
+}
+
+int BitWriter::position() const noexcept {
+  //Returns the number of bits written
+  return position_;
+}
+
+int BitWriter::size() const noexcept {
+  //Rounds up to a whole byte
+  return min(position_, capacityBits_) / 8 + (min(position_, capacityBits_) % 8 != 0);
+}
+
+bool BitWriter::overflowed() const noexcept {
+  //Returns whether the buffer was too small
+  return overflowed_;
+}
+
+BitReader::BitReader(const uint8_t* buffer, int size) noexcept
+  : buffer_(buffer), sizeBits_(size * 8) {}
+
+uint32_t BitReader::read(int bits) noexcept {
+  if (position_ + bits > sizeBits_) {
+    overflowed_ = true;
+    return 0;
+  }
+
+  //Reads the bits lowest first, the same way they were written
+  uint32_t value = 0;
+  for (int done = 0; done < bits;) {
+    int bit = position_ + done;
+    int chunk = min(bits - done, 8 - bit % 8);
+    uint32_t piece = (buffer_[bit / 8] >> (bit % 8)) & ((1u << chunk) - 1);
+    value |= piece << done;
+    done += chunk;
+  }
+  position_ += bits;
+  return value;
+}
+
+bool BitReader::overflowed() const noexcept {
+  //Returns whether the buffer ran out
+  return overflowed_;
+}
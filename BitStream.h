@@ -0,0 +1,100 @@
+#ifndef ASTEROIDS_BITSTREAM_H
+#define ASTEROIDS_BITSTREAM_H
+
+#include <cstdint>
+
+namespace asteroids {
+
+/**
+ * Packs values of any number of bits one after the other into a byte buffer,
+ * so a field only takes as many bits as its range needs. Writing past the end
+ * of the buffer is ignored and remembered rather than overflowing it.
+ *
+ * @author Jai Aslam
+ */
+class BitWriter {
+public:
+  /**
+  * Constructs a writer filling the given buffer from its start.
+  */
+  BitWriter(/** The buffer to fill */std::uint8_t* buffer, /** The size of the buffer in bytes */int capacity) noexcept;
+
+  /**
+  * Writes the low bits of a value.
+  */
+  void write(/** The value to write */std::uint32_t value, /** The number of bits to write, at most 32 */int bits) noexcept;
+
+  /**
+  * Overwrites bits written earlier, e.g. a count that was only known afterwards.
+  */
+  void patch(/** The bit position returned by position */int position, /** The value to write */std::uint32_t value, /** The number of bits to write, at most 32 */int bits) noexcept;
+
+  /**
+  * @returns the number of bits written so far.
+  */
+  int position() const noexcept;
+
+  /**
+  * @returns the number of bytes holding the bits written so far.
+  */
+  int size() const noexcept;
+
+  /**
+  * @returns whether anything was written past the end of the buffer.
+  */
+  bool overflowed() const noexcept;
+
+private:
+  /** The buffer being filled */
+  std::uint8_t* buffer_;
+
+  /** The size of the buffer in bits */
+  const int capacityBits_;
+
+  /** The number of bits written so far */
+  int position_ = 0;
+
+  /** Whether anything was written past the end of the buffer */
+  bool overflowed_ = false;
+};
+
+/**
+ * Reads back the values a BitWriter packed. Reading past the end of the
+ * buffer gives zeros and is remembered, so a truncated or corrupt packet can
+ * be decoded to the end and then thrown away.
+ *
+ * @author Jai Aslam
+ */
+class BitReader {
+public:
+  /**
+  * Constructs a reader starting at the beginning of the given buffer.
+  */
+  BitReader(/** The buffer to read */const std::uint8_t* buffer, /** The size of the buffer in bytes */int size) noexcept;
+
+  /**
+  * @returns the next value of the given number of bits.
+  */
+  std::uint32_t read(/** The number of bits to read, at most 32 */int bits) noexcept;
+
+  /**
+  * @returns whether anything was read past the end of the buffer.
+  */
+  bool overflowed() const noexcept;
+
+private:
+  /** The buffer being read */
+  const std::uint8_t* buffer_;
+
+  /** The size of the buffer in bits */
+  const int sizeBits_;
+
+  /** The number of bits read so far */
+  int position_ = 0;
+
+  /** Whether anything was read past the end of the buffer */
+  bool overflowed_ = false;
+};
+}
+
+#endif
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <math.h>
+
 #include "Bullet.h"
 
 using namespace std;
@@ -7,35 +9,49 @@ using namespace asteroids;
 Bullet::Bullet(int initialX, int initialY, int initialDirection) {
   //Initializes the initial position of the bullet and the direction
   //it is traveling in.
-  x_ = initialX;
-  y_ = initialY;
+  position_ = FixedVector::fromInt(initialX, initialY);
   direction_ = initialDirection;
+  heading_ = unitVector(direction_);
 }
 
 Bullet::~Bullet() {}
 
 int Bullet::getX() const noexcept {
-  //Returns the current x coordinate of the bullet.
-  return x_;
+  //Returns the current x coordinate of the bullet to the nearest pixel.
+  return position_.x.round();
 } 
 
 int Bullet::getY() const noexcept {
-  //Returns the curreny y coordinate of the bullet.
-  return y_;
+  //Returns the curreny y coordinate of the bullet to the nearest pixel.
+  return position_.y.round();
+}
+
+int Bullet::getDirection() const noexcept {
+  //Returns the direction the bullet is traveling in.
+  return direction_;
+}
+
+const FixedVector& Bullet::getHeading() const noexcept {
+  //Returns the direction of travel
+  return heading_;
+}
+
+const FixedVector& Bullet::getPosition() const noexcept {
+  //Returns the exact position of the bullet.
+  return position_;
 }
 
 void Bullet::updatePosition(int velocityMagnitude) noexcept {
-  //Updates x position using the x-component of velocity
-  x_ += velocityMagnitude * cos(direction_);
-  //Updates y position using the y-component of velocity
-  y_ += velocityMagnitude * sin(direction_);
+  //Moves along the direction of travel, keeping the fraction of a pixel for next time
+  position_ += heading_ * velocityMagnitude;
 }
 
 void Bullet::draw(SDL_Renderer* r) noexcept {
   //Draws the bullet as a short line between two points.
   SDL_Point bulletPoints[2];
   bulletPoints[0] = {getX(), getY()};
-  bulletPoints[1] = {(int) (getX() + 3 * cos(direction_)),(int) (getY() + 3 * sin(direction_))};
+  FixedVector tail = position_ + heading_ * 3;
+  bulletPoints[1] = {tail.x.round(), tail.y.round()};
 
   //Draws the bullet in white
   SDL_SetRenderDrawColor(r, 255, 255, 255, 255);
@@ -45,16 +61,21 @@ void Bullet::draw(SDL_Renderer* r) noexcept {
 bool Bullet::bulletOnScreen() const noexcept {
   //If the bullet has gone off the right or left of the screen
   //then it is not on the screen.
-  if (x_ > 640 || x_ < 0) {
+  if (position_.x > Fixed::fromInt(640) || position_.x < Fixed::fromInt(0)) {
     return false;
   }
   //If the bullet has gone off the bottom or the top of the screen
   //then it is not on the screen.
-  if (y_ > 480 || y_ < 0) {
+  if (position_.y > Fixed::fromInt(480) || position_.y < Fixed::fromInt(0)) {
     return false;
   }
 
   return true;
 }
 
-
+int Bullet::maxOnScreen(int width, int height, int step) noexcept {
+  //A bullet flies straight, so it crosses at most the diagonal of the
+  //screen, and lives one tick past leaving it while a new one is fired
+  long diagonal = sqrt((double) width * width + (double) height * height);
+  return diagonal / max(step, 1) + 3;
+}
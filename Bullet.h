@@ -3,6 +3,8 @@
 
 #include <SDL2/SDL.h>
 
+#include "Fixed.h"
+
 namespace asteroids {
 
 /**
@@ -33,6 +35,21 @@ public:
   */
   int getY() const noexcept;
 
+  /**
+  * @returns the direction in radians that the bullet is traveling in.
+  */
+  int getDirection() const noexcept;
+
+  /**
+  * @returns the current position of the bullet to a fraction of a pixel.
+  */
+  const FixedVector& getPosition() const noexcept;
+
+  /**
+  * @returns the unit vector pointing in the direction of travel.
+  */
+  const FixedVector& getHeading() const noexcept;
+
   /**
   * Updates the current position of bullet the given
   * the magnitude of the velocity vector.   
@@ -49,16 +66,22 @@ public:
   */
   bool bulletOnScreen() const noexcept;
 
+  /**
+  * @returns the most bullets a ship firing every tick can have on a screen
+  * of the given size at once.
+  */
+  static int maxOnScreen(/** The width of the screen */int width, /** The height of the screen */int height, /** How far a bullet moves each tick */int step) noexcept;
+
 private:
-  /** The current x coordinate of the bullet. */
-  int x_;
- 
-  /** The current y coordinate of the bullet. */
-  int y_;
+  /** The current position of the bullet. */
+  FixedVector position_;
 
-  /** The direction in degrees that the bullet is traveling in. */
+  /** The direction in radians that the bullet is traveling in. */
   int direction_;
 
+  /** The unit vector pointing in the direction the bullet is traveling in. */
+  FixedVector heading_;
+
 };
 }
 #endif
@@ -0,0 +1,63 @@
+#include <math.h>
+#include <cstdint>
+
+#include "Collision.h"
+
+using namespace std;
+using namespace asteroids;
+
+/** The fraction bits dropped from 16.16 positions so squares and products fit in 64 bits */
+static constexpr int kDroppedBits = 8;
+
+/** A product of two 64 bit values, which needs twice the bits */
+typedef __int128 Wide;
+
+/**
+ * @returns the integer square root of the given value, rounded down.
+ */
+static int64_t squareRoot(/** The value */Wide value) {
+  //The floating point guess is corrected so the answer is exact everywhere
+  Wide root = (Wide) sqrt((double) value);
+  while (root * root > value) {
+    root--;
+  }
+  while ((root + 1) * (root + 1) <= value) {
+    root++;
+  }
+  return (int64_t) root;
+}
+
+int asteroids::timeOfImpact(FixedVector start, FixedVector end, int radius) noexcept {
+  //Works in 1/256ths of a pixel
+  int64_t px = start.x.raw >> kDroppedBits;
+  int64_t py = start.y.raw >> kDroppedBits;
+  int64_t dx = (end.x.raw >> kDroppedBits) - px;
+  int64_t dy = (end.y.raw >> kDroppedBits) - py;
+  int64_t reach = (int64_t) radius << (Fixed::kFractionBits - kDroppedBits);
+
+  //Already touching at the start of the tick
+  int64_t startDistance = px * px + py * py;
+  if (startDistance <= reach * reach) {
+    return 0;
+  }
+
+  //Finds the closest the path comes to the origin, which is its start if it
+  //heads away and its end if it never gets past the closest point
+  int64_t along = -(px * dx + py * dy);
+  int64_t length = dx * dx + dy * dy;
+  if (along <= 0 || length == 0) {
+    return -1;
+  }
+  int64_t step = along >= length ? kTickSteps : (along * kTickSteps) / length;
+  int64_t cx = px + dx * step / kTickSteps;
+  int64_t cy = py + dy * step / kTickSteps;
+  if (cx * cx + cy * cy > reach * reach) {
+    return -1;
+  }
+
+  //It hits, so solves |p + d t| = reach for the first t. A long path makes
+  //the square of along too big for 64 bits, though the root always fits
+  Wide discriminant = (Wide) along * along - (Wide) length * (startDistance - reach * reach);
+  int64_t first = ((along - squareRoot(discriminant > 0 ? discriminant : 0)) * kTickSteps) / length;
+  return (int) (first < 0 ? 0 : first > kTickSteps ? kTickSteps : first);
+}
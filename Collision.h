@@ -0,0 +1,29 @@
+#ifndef ASTEROIDS_COLLISION_H
+#define ASTEROIDS_COLLISION_H
+
+#include "Fixed.h"
+
+namespace asteroids {
+
+/** Times of impact are measured in this many steps per tick */
+constexpr int kTickSteps = 256;
+
+/**
+ * Finds when during a tick a point moving in a straight line first comes
+ * within the given distance of the origin. Testing the whole path rather
+ * than where the point ends up means nothing can pass straight through
+ * something else between two ticks, however far it moves in one.
+ *
+ * A bullet hitting an asteroid is the bullet's path relative to the
+ * asteroid against the asteroid's radius, and the ship hitting an asteroid
+ * is the same with the two radii added together.
+ *
+ * The arithmetic is all integer, so every platform agrees on every hit.
+ *
+ * @returns the time of impact in steps from 0 to kTickSteps, 0 if the point
+ * starts within the distance, or -1 if it never comes within it this tick.
+ */
+int timeOfImpact(/** Where the point starts the tick */FixedVector start, /** Where the point ends the tick */FixedVector end, /** The distance from the origin in pixels */int radius) noexcept;
+}
+
+#endif
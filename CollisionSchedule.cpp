@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <climits>
+#include <math.h>
+
+#include "Collision.h"
+#include "CollisionSchedule.h"
+
+using namespace std;
+using namespace asteroids;
+
+/**
+ * @returns the given fixed point value in pixels.
+ */
+static double pixels(/** The value */Fixed value) noexcept {
+  return value.raw / (double) (1 << Fixed::kFractionBits);
+}
+
+CollisionSchedule::CollisionSchedule(int asteroidStep, int bulletStep, int shipSize)
+  : asteroidStep_(asteroidStep), bulletStep_(bulletStep), shipSize_(shipSize) {}
+
+CollisionSchedule::~CollisionSchedule() {}
+
+void CollisionSchedule::reset() noexcept {
+  //Starts over with nothing queued or tracked
+  now_ = 0;
+  events_.clear();
+  asteroidIds_.clear();
+  bulletIds_.clear();
+  asteroidSlots_.clear();
+  bulletSlots_.clear();
+  freeAsteroids_.clear();
+  freeBullets_.clear();
+  wrapped_.clear();
+  shipHits_.clear();
+  shipVersion_ = 0;
+}
+
+void CollisionSchedule::clearAsteroids() noexcept {
+  //Frees every asteroid id, their events go stale with them
+  for (int id : asteroidIds_) {
+    asteroidSlots_[id].index = -1;
+    asteroidSlots_[id].version++;
+    freeAsteroids_.push_back(id);
+  }
+  asteroidIds_.clear();
+  wrapped_.clear();
+  shipHits_.clear();
+}
+
+void CollisionSchedule::reserve(int asteroids, int bullets) noexcept {
+  //Every asteroid may wrap or threaten the ship in the same tick
+  asteroidIds_.reserve(asteroids);
+  asteroidSlots_.reserve(asteroids);
+  freeAsteroids_.reserve(asteroids);
+  wrapped_.reserve(asteroids);
+  shipHits_.reserve(asteroids);
+  bulletIds_.reserve(bullets);
+  bulletSlots_.reserve(bullets);
+  freeBullets_.reserve(bullets);
+
+  //Each asteroid and bullet usually has an event or two queued at a time
+  events_.reserve(2 * (asteroids + bullets));
+}
+
+void CollisionSchedule::track(const vector<Asteroid>& asteroids, const vector<Bullet>& bullets, FixedVector ship, bool shipMoved) noexcept {
+  //A moved ship's old events no longer apply
+  if (shipMoved) {
+    shipVersion_++;
+  }
+
+  //Asteroids which wrapped start their paths over from the other side
+  for (const auto& [id, version] : wrapped_) {
+    const Slot& slot = asteroidSlots_[id];
+    if (slot.index < 0 || slot.version != version) {
+      continue;
+    }
+    const Asteroid& ast = asteroids[slot.index];
+    for (unsigned j = 0; j < bulletIds_.size(); j++) {
+      predictBullet(ast, id, bullets[j], bulletIds_[j]);
+    }
+    if (!shipMoved) {
+      predictShip(ast, id, ship);
+    }
+  }
+  wrapped_.clear();
+
+  //New bullets against the asteroids already tracked
+  size_t oldAsteroids = asteroidIds_.size();
+  for (unsigned j = bulletIds_.size(); j < bullets.size(); j++) {
+    int id = claim(bulletSlots_, freeBullets_, j);
+    bulletIds_.push_back(id);
+    for (unsigned i = 0; i < oldAsteroids; i++) {
+      predictBullet(asteroids[i], asteroidIds_[i], bullets[j], id);
+    }
+  }
+
+  //New asteroids against every bullet and the ship
+  for (unsigned i = oldAsteroids; i < asteroids.size(); i++) {
+    int id = claim(asteroidSlots_, freeAsteroids_, i);
+    asteroidIds_.push_back(id);
+    for (unsigned j = 0; j < bulletIds_.size(); j++) {
+      predictBullet(asteroids[i], id, bullets[j], bulletIds_[j]);
+    }
+    if (!shipMoved) {
+      predictShip(asteroids[i], id, ship);
+    }
+  }
+
+  //A moved ship against every asteroid
+  if (shipMoved) {
+    for (unsigned i = 0; i < asteroidIds_.size(); i++) {
+      predictShip(asteroids[i], asteroidIds_[i], ship);
+    }
+  }
+}
+
+void CollisionSchedule::wrapped(int asteroid) noexcept {
+  //Its events were predicted for a path it is no longer on
+  int id = asteroidIds_[asteroid];
+  asteroidSlots_[id].version++;
+  wrapped_.push_back({id, asteroidSlots_[id].version});
+}
+
+void CollisionSchedule::eraseAsteroid(int asteroid) noexcept {
+  release(asteroidIds_, asteroidSlots_, freeAsteroids_, asteroid);
+}
+
+void CollisionSchedule::eraseBullet(int bullet) noexcept {
+  release(bulletIds_, bulletSlots_, freeBullets_, bullet);
+}
+
+int CollisionSchedule::collect(const vector<Asteroid>& asteroids, const vector<Bullet>& bullets, FixedVector ship, bool shipStill, vector<pair<int, int>>& hits) noexcept {
+  now_++;
+  int tests = 0;
+
+  //Tests the pairs which are due, dropping events that went stale
+  while (!events_.empty() && events_.front().tick <= now_) {
+    pop_heap(events_.begin(), events_.end(), later);
+    Event event = events_.back();
+    events_.pop_back();
+
+    const Slot& asteroid = asteroidSlots_[event.asteroid];
+    if (asteroid.index < 0 || asteroid.version != event.asteroidVersion) {
+      continue;
+    }
+    if (event.bullet < 0) {
+      //A ship which moved is tested against everything by the game instead
+      if (shipVersion_ != event.bulletVersion || !shipStill) {
+        continue;
+      }
+      tests++;
+      if (testShip(asteroids[asteroid.index], ship) >= 0) {
+        shipHits_.push_back({event.asteroid, asteroid.version});
+      }
+    }
+    else {
+      const Slot& bullet = bulletSlots_[event.bullet];
+      if (bullet.index < 0 || bullet.version != event.bulletVersion) {
+        continue;
+      }
+      tests++;
+      int time = testBullet(asteroids[asteroid.index], bullets[bullet.index]);
+      if (time >= 0) {
+        record(hits, bullet.index, time, asteroid.index);
+      }
+    }
+
+    //The pair stays queued for the rest of its window
+    if (event.until > now_) {
+      event.tick = now_ + 1;
+      events_.push_back(event);
+      push_heap(events_.begin(), events_.end(), later);
+    }
+  }
+
+  //An asteroid which wrapped has no predictions this tick, so it is tested
+  //against everything
+  for (const auto& [id, version] : wrapped_) {
+    const Slot& slot = asteroidSlots_[id];
+    if (slot.version != version) {
+      continue;
+    }
+    const Asteroid& ast = asteroids[slot.index];
+    for (unsigned j = 0; j < bullets.size(); j++) {
+      tests++;
+      int time = testBullet(ast, bullets[j]);
+      if (time >= 0) {
+        record(hits, j, time, slot.index);
+      }
+    }
+    if (shipStill) {
+      tests++;
+      if (testShip(ast, ship) >= 0) {
+        shipHits_.push_back({id, version});
+      }
+    }
+  }
+  return tests;
+}
+
+bool CollisionSchedule::shipHit(const vector<Asteroid>& asteroids, FixedVector ship) noexcept {
+  //An asteroid that hit the ship counts unless a bullet destroyed it first
+  bool hit = false;
+  for (const auto& [id, version] : shipHits_) {
+    const Slot& slot = asteroidSlots_[id];
+    hit = hit || (slot.index >= 0 && slot.version == version);
+  }
+  shipHits_.clear();
+
+  //Asteroids added this tick have no predictions yet
+  for (unsigned i = asteroidIds_.size(); i < asteroids.size() && !hit; i++) {
+    hit = testShip(asteroids[i], ship) >= 0;
+  }
+  return hit;
+}
+
+bool CollisionSchedule::later(const Event& a, const Event& b) noexcept {
+  //Puts the earliest event at the front of the heap
+  return a.tick > b.tick;
+}
+
+int CollisionSchedule::claim(vector<Slot>& slots, vector<int>& free, int index) noexcept {
+  //Reuses a free id, whose version already differs from any event left for it
+  if (!free.empty()) {
+    int id = free.back();
+    free.pop_back();
+    slots[id].index = index;
+    return id;
+  }
+  slots.push_back({index, 0});
+  return slots.size() - 1;
+}
+
+void CollisionSchedule::release(vector<int>& ids, vector<Slot>& slots, vector<int>& free, int index) noexcept {
+  //Frees the id, making its events stale
+  int id = ids[index];
+  slots[id].index = -1;
+  slots[id].version++;
+  free.push_back(id);
+
+  //Everything after it moves down one, as it does in the game's list
+  ids.erase(ids.begin() + index);
+  for (unsigned i = index; i < ids.size(); i++) {
+    slots[ids[i]].index = i;
+  }
+}
+
+void CollisionSchedule::predict(FixedVector offset, FixedVector step, int reach, int asteroid, int bullet) noexcept {
+  //Solves |offset + step t| = reach for the ticks t the pair spends within
+  //reach, padded so rounding can never leave out a tick the exact test hits
+  double px = pixels(offset.x);
+  double py = pixels(offset.y);
+  double dx = pixels(step.x);
+  double dy = pixels(step.y);
+  double distance = reach + kMargin;
+  double a = dx * dx + dy * dy;
+  double b = px * dx + py * dy;
+  double c = px * px + py * py - distance * distance;
+
+  long long first = 1;
+  long long last = LLONG_MAX;
+  if (a == 0) {
+    //Neither moves relative to the other, so they touch forever or never
+    if (c > 0) {
+      return;
+    }
+  }
+  else {
+    double discriminant = b * b - a * c;
+    if (discriminant < 0) {
+      return;
+    }
+    double root = sqrt(discriminant);
+    double enter = (-b - root) / a;
+    double leave = (-b + root) / a;
+    if (leave < 0) {
+      return;
+    }
+
+    //Tick k sweeps the path from t = k - 1 to t = k, with a tick to spare either side
+    first = max(1LL, (long long) floor(enter));
+    last = (long long) ceil(leave) + 1;
+  }
+
+  unsigned otherVersion = bullet < 0 ? shipVersion_ : bulletSlots_[bullet].version;
+  events_.push_back({now_ + first, last == LLONG_MAX ? LLONG_MAX : now_ + last, asteroid, asteroidSlots_[asteroid].version, bullet, otherVersion});
+  push_heap(events_.begin(), events_.end(), later);
+}
+
+void CollisionSchedule::predictBullet(const Asteroid& ast, int asteroid, const Bullet& bullet, int bulletId) noexcept {
+  //The bullet's path relative to the asteroid against the asteroid's radius
+  FixedVector step = bullet.getHeading() * bulletStep_ - ast.getHeading() * asteroidStep_;
+  predict(bullet.getPosition() - ast.getPosition(), step, ast.getRadius(), asteroid, bulletId);
+}
+
+void CollisionSchedule::predictShip(const Asteroid& ast, int asteroid, FixedVector ship) noexcept {
+  //The standing ship's path relative to the asteroid against both radii
+  FixedVector step = FixedVector{} - ast.getHeading() * asteroidStep_;
+  predict(ship - ast.getPosition(), step, ast.getRadius() + shipSize_, asteroid, -1);
+}
+
+int CollisionSchedule::testBullet(const Asteroid& ast, const Bullet& bullet) const noexcept {
+  //The same swept test the game runs on every pair
+  FixedVector astEnd = ast.getPosition();
+  FixedVector astStart = astEnd - ast.getHeading() * asteroidStep_;
+  FixedVector bulletEnd = bullet.getPosition();
+  FixedVector bulletStart = bulletEnd - bullet.getHeading() * bulletStep_;
+  return timeOfImpact(bulletStart - astStart, bulletEnd - astEnd, ast.getRadius());
+}
+
+int CollisionSchedule::testShip(const Asteroid& ast, FixedVector ship) const noexcept {
+  //The same swept test the game runs for a ship which did not move
+  FixedVector astEnd = ast.getPosition();
+  FixedVector astStart = astEnd - ast.getHeading() * asteroidStep_;
+  return timeOfImpact(ship - astStart, ship - astEnd, ast.getRadius() + shipSize_);
+}
+
+void CollisionSchedule::record(vector<pair<int, int>>& hits, int bullet, int time, int asteroid) noexcept {
+  //Keeps the earliest hit, and on a tie the first asteroid
+  pair<int, int>& hit = hits[bullet];
+  if (hit.first < 0 || time < hit.first || (time == hit.first && asteroid < hit.second)) {
+    hit = {time, asteroid};
+  }
+}
@@ -0,0 +1,227 @@
+#ifndef ASTEROIDS_COLLISIONSCHEDULE_H
+#define ASTEROIDS_COLLISIONSCHEDULE_H
+
+#include <vector>
+
+#include "Asteroid.h"
+#include "Bullet.h"
+#include "Fixed.h"
+
+namespace asteroids {
+
+/**
+ * Predicts when pairs of entities will collide so a tick only tests the
+ * pairs that are due rather than every pair on the screen.
+ *
+ * Between wraps, asteroids and bullets move the same exact fixed point step
+ * every tick and the ship only moves on input, so the path of one entity
+ * relative to another is a straight line. When an entity appears or changes
+ * course the schedule works out the window of ticks during which each pair
+ * could touch and queues an event for its start. A tick pops the events that
+ * have come due and tests those pairs with the same swept test the full
+ * check uses, keeping the event queued while the window lasts. The window is
+ * padded so the floating point prediction never misses a hit the integer
+ * test would find, which keeps every hit identical to testing all pairs.
+ *
+ * A split, wrap or move of the ship makes the entity's queued events stale.
+ * Stale events are dropped as they come due rather than searched for, by
+ * giving every entity a version that the events have to match.
+ *
+ * The schedule mirrors the order of the game's asteroids and bullets, so the
+ * game has to tell it about every asteroid or bullet it erases.
+ *
+ * @author Jai Aslam
+ */
+class CollisionSchedule {
+public:
+  /**
+  * Constructs an empty schedule.
+  */
+  CollisionSchedule(/** How far an asteroid moves each tick */int asteroidStep, /** How far a bullet moves each tick */int bulletStep, /** The radius of the ship */int shipSize);
+
+  /**
+  * Destructs the schedule.
+  */
+  ~CollisionSchedule();
+
+  /**
+  * Forgets every entity and event, keeping the storage.
+  */
+  void reset() noexcept;
+
+  /**
+  * Forgets every asteroid, for when the screen is cleared.
+  */
+  void clearAsteroids() noexcept;
+
+  /**
+  * Makes room to track the given numbers of asteroids and bullets.
+  */
+  void reserve(/** The number of asteroids */int asteroids, /** The number of bullets */int bullets) noexcept;
+
+  /**
+  * Queues the collisions of the asteroids and bullets added to the ends of
+  * the lists since the last call, of the asteroids that wrapped this tick
+  * and of the ship if it moved. The entities must all be where they are at
+  * the end of the same tick.
+  */
+  void track(/** The asteroids on the screen */const std::vector<Asteroid>& asteroids, /** The bullets on the screen */const std::vector<Bullet>& bullets, /** Where the ship is */FixedVector ship, /** Whether the ship moved since the last call */bool shipMoved) noexcept;
+
+  /**
+  * Notes that the given asteroid wrapped around the screen this tick.
+  */
+  void wrapped(/** The index of the asteroid */int asteroid) noexcept;
+
+  /**
+  * Forgets the given asteroid, which the game is about to erase.
+  */
+  void eraseAsteroid(/** The index of the asteroid */int asteroid) noexcept;
+
+  /**
+  * Forgets the given bullet, which the game is about to erase.
+  */
+  void eraseBullet(/** The index of the bullet */int bullet) noexcept;
+
+  /**
+  * Moves on to the next tick and tests the pairs which are due, along with
+  * every pair involving an asteroid that wrapped. Each bullet's earliest hit
+  * is written into the hits as the time of impact and asteroid index, and
+  * hits on the ship are kept for shipHit.
+  *
+  * @returns the number of pairs tested.
+  */
+  int collect(/** The asteroids after moving */const std::vector<Asteroid>& asteroids, /** The bullets after moving */const std::vector<Bullet>& bullets, /** Where the ship is */FixedVector ship, /** Whether the ship stood still this tick, only then are its events tested */bool shipStill, /** Each bullet's earliest hit, -1 if none */std::vector<std::pair<int, int>>& hits) noexcept;
+
+  /**
+  * @returns whether an asteroid which collect found hitting the ship is
+  * still on the screen, or an asteroid added since the last track, such as
+  * the pieces of a split, hits the standing ship this tick.
+  */
+  bool shipHit(/** The asteroids on the screen */const std::vector<Asteroid>& asteroids, /** Where the ship is */FixedVector ship) noexcept;
+
+private:
+  /** The extra pixels the predicted windows are padded by */
+  static constexpr double kMargin = 2.0;
+
+  /** A pair that may collide during a window of ticks */
+  struct Event {
+    /** The next tick the pair is tested on */
+    long long tick;
+
+    /** The last tick the pair is tested on */
+    long long until;
+
+    /** The asteroid's id */
+    int asteroid;
+
+    /** The version of the asteroid the event was predicted for */
+    unsigned asteroidVersion;
+
+    /** The bullet's id, -1 for the ship */
+    int bullet;
+
+    /** The version of the bullet or ship the event was predicted for */
+    unsigned bulletVersion;
+  };
+
+  /** Where an entity is in the game's list and how many times its events went stale */
+  struct Slot {
+    /** The index in the game's list, -1 while the id is free */
+    int index;
+
+    /** Changes whenever the entity's queued events stop applying */
+    unsigned version;
+  };
+
+  /** How far an asteroid moves each tick */
+  const int asteroidStep_;
+
+  /** How far a bullet moves each tick */
+  const int bulletStep_;
+
+  /** The radius of the ship */
+  const int shipSize_;
+
+  /** The tick the entities' positions belong to */
+  long long now_ = 0;
+
+  /** The queued events, a heap with the earliest at the front */
+  std::vector<Event> events_;
+
+  /** The id of each asteroid in the game's order */
+  std::vector<int> asteroidIds_;
+
+  /** The id of each bullet in the game's order */
+  std::vector<int> bulletIds_;
+
+  /** The asteroids by id */
+  std::vector<Slot> asteroidSlots_;
+
+  /** The bullets by id */
+  std::vector<Slot> bulletSlots_;
+
+  /** The asteroid ids which are free to reuse */
+  std::vector<int> freeAsteroids_;
+
+  /** The bullet ids which are free to reuse */
+  std::vector<int> freeBullets_;
+
+  /** The ids of the asteroids which wrapped this tick, with their versions */
+  std::vector<std::pair<int, unsigned>> wrapped_;
+
+  /** The ids of the asteroids which collect found hitting the ship, with their versions */
+  std::vector<std::pair<int, unsigned>> shipHits_;
+
+  /** The version of the ship's position */
+  unsigned shipVersion_ = 0;
+
+  /**
+  * @returns whether the first event is due after the second.
+  */
+  static bool later(/** The first event */const Event& a, /** The second event */const Event& b) noexcept;
+
+  /**
+  * @returns a free id in the given slots, pointing it at the given index.
+  */
+  static int claim(/** The slots */std::vector<Slot>& slots, /** The free ids */std::vector<int>& free, /** The index the id refers to */int index) noexcept;
+
+  /**
+  * Frees the id at the given index of the game's list and shifts the ids after it down.
+  */
+  static void release(/** The ids in the game's order */std::vector<int>& ids, /** The slots */std::vector<Slot>& slots, /** The free ids */std::vector<int>& free, /** The index */int index) noexcept;
+
+  /**
+  * Queues the window in which a point starting at the given offset and
+  * moving the given step each tick is within reach of the origin, if any.
+  */
+  void predict(/** Where the point starts relative to the origin */FixedVector offset, /** How far the point moves each tick */FixedVector step, /** The distance from the origin */int reach, /** The asteroid's id */int asteroid, /** The bullet's id, -1 for the ship */int bullet) noexcept;
+
+  /**
+  * Queues the window of a bullet and an asteroid.
+  */
+  void predictBullet(/** The asteroid */const Asteroid& ast, /** The asteroid's id */int asteroid, /** The bullet */const Bullet& bullet, /** The bullet's id */int bulletId) noexcept;
+
+  /**
+  * Queues the window of the ship and an asteroid.
+  */
+  void predictShip(/** The asteroid */const Asteroid& ast, /** The asteroid's id */int asteroid, /** Where the ship is */FixedVector ship) noexcept;
+
+  /**
+  * @returns the time of impact of a bullet and an asteroid this tick, -1 for a miss.
+  */
+  int testBullet(/** The asteroid */const Asteroid& ast, /** The bullet */const Bullet& bullet) const noexcept;
+
+  /**
+  * @returns the time of impact of the standing ship and an asteroid this tick, -1 for a miss.
+  */
+  int testShip(/** The asteroid */const Asteroid& ast, /** Where the ship is */FixedVector ship) const noexcept;
+
+  /**
+  * Keeps a bullet's hit if it is earlier than the one it already has,
+  * breaking ties towards the first asteroid like a full check does.
+  */
+  static void record(/** Each bullet's earliest hit */std::vector<std::pair<int, int>>& hits, /** The bullet */int bullet, /** The time of impact */int time, /** The asteroid */int asteroid) noexcept;
+};
+}
+
+#endif
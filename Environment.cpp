@@ -0,0 +1,191 @@
+#include <math.h>
+#include <cstring>
+#include <algorithm>
+
+#include "Environment.h"
+
+using namespace std;
+using namespace asteroids;
+
+VectorEnvironment::VectorEnvironment(int count, int maxEntities, int gridCellSize, int width, int height)
+  : maxEntities_(maxEntities), gridCellSize_(gridCellSize) {
+  //Every game runs headless, there is nothing to draw them on, and none
+  //publishes statistics since they would all share the one segment
+  GameOptions options;
+  options.headless = true;
+  options.metrics = false;
+  games_.reserve(count);
+  for (int i = 0; i < count; i++) {
+    games_.push_back(unique_ptr<Game>(new Game(width, height, options)));
+  }
+
+  //The grid covers the whole screen, rounding partial cells up
+  if (gridCellSize_ > 0) {
+    gridWidth_ = (width + gridCellSize_ - 1) / gridCellSize_;
+    gridHeight_ = (height + gridCellSize_ - 1) / gridCellSize_;
+  }
+
+  //Directions are whole radians so every possible one is looked up once here
+  for (int direction = -kDirectionOffset; direction <= kDirectionOffset; direction++) {
+    cos_[direction + kDirectionOffset] = cos(direction);
+    sin_[direction + kDirectionOffset] = sin(direction);
+  }
+}
+
+VectorEnvironment::~VectorEnvironment() {}
+
+void VectorEnvironment::bind(float* entities, uint8_t* grid, float* rewards, uint8_t* dones) noexcept {
+  //Remembers where the caller wants everything written
+  entities_ = entities;
+  grid_ = grid;
+  rewards_ = rewards;
+  dones_ = dones;
+}
+
+void VectorEnvironment::reset(unsigned seed) noexcept {
+  //Restarts every game with its own seed and writes its first observation
+  nextSeed_ = seed;
+  for (unsigned i = 0; i < games_.size(); i++) {
+    games_[i]->reset(nextSeed_++);
+    if (rewards_) {
+      rewards_[i] = 0;
+    }
+    if (dones_) {
+      dones_[i] = 0;
+    }
+    observe(i);
+  }
+}
+
+void VectorEnvironment::step(const uint8_t* actions) noexcept {
+  for (unsigned i = 0; i < games_.size(); i++) {
+    Game& game = *games_[i];
+
+    //Applies the action the same way the keyboard would and advances a tick
+    int scoreBefore = game.getScore();
+    game.applyAction(actions[i]);
+    game.tick();
+
+    //The reward is whatever the tick added to the score
+    bool done = !game.stillAlive();
+    if (rewards_) {
+      rewards_[i] = game.getScore() - scoreBefore;
+    }
+    if (dones_) {
+      dones_[i] = done;
+    }
+
+    //A finished game starts over straight away
+    if (done) {
+      game.reset(nextSeed_++);
+    }
+    observe(i);
+  }
+}
+
+int VectorEnvironment::size() const noexcept {
+  //Returns the number of games
+  return games_.size();
+}
+
+int VectorEnvironment::entityStride() const noexcept {
+  //Returns the number of floats written for each game
+  return maxEntities_ * kEntityFeatures;
+}
+
+int VectorEnvironment::gridWidth() const noexcept {
+  //Returns the number of grid columns
+  return gridWidth_;
+}
+
+int VectorEnvironment::gridHeight() const noexcept {
+  //Returns the number of grid rows
+  return gridHeight_;
+}
+
+const Game& VectorEnvironment::game(int index) const noexcept {
+  //Returns the game with the given index
+  return *games_[index];
+}
+
+void VectorEnvironment::observe(int index) noexcept {
+  const Game& game = *games_[index];
+  const float width = game.getWidth();
+  const float height = game.getHeight();
+
+  if (entities_) {
+    //Each game writes to its own slice of the caller's buffer
+    float* out = entities_ + index * entityStride();
+    float* end = out + entityStride();
+
+    //The ship always comes first
+    const Ship& player = game.getPlayer();
+    out[0] = EntityShip;
+    out[1] = player.getX() / width;
+    out[2] = player.getY() / height;
+    out[3] = 0;
+    out[4] = cos_[player.getAngle() + kDirectionOffset];
+    out[5] = sin_[player.getAngle() + kDirectionOffset];
+    out += kEntityFeatures;
+
+    //Then the asteroids, for as long as there is room
+    for (const Asteroid& ast : game.getAsteroids()) {
+      if (out == end) {
+        break;
+      }
+      out[0] = EntityAsteroid;
+      out[1] = ast.getX() / width;
+      out[2] = ast.getY() / height;
+      out[3] = ast.getRadius() / 50.0f;
+      out[4] = cos_[ast.getDirection() + kDirectionOffset];
+      out[5] = sin_[ast.getDirection() + kDirectionOffset];
+      out += kEntityFeatures;
+    }
+
+    //Then the bullets, which the ship could always fire again
+    for (const Bullet& bullet : game.getBullets()) {
+      if (out == end) {
+        break;
+      }
+      out[0] = EntityBullet;
+      out[1] = bullet.getX() / width;
+      out[2] = bullet.getY() / height;
+      out[3] = 0;
+      out[4] = cos_[bullet.getDirection() + kDirectionOffset];
+      out[5] = sin_[bullet.getDirection() + kDirectionOffset];
+      out += kEntityFeatures;
+    }
+
+    //Pads the rest of the slice with empty entities
+    fill(out, end, 0.0f);
+  }
+
+  if (grid_ && gridCellSize_ > 0) {
+    //Clears the grid of this game before marking everything on it
+    uint8_t* grid = grid_ + index * gridWidth_ * gridHeight_;
+    memset(grid, 0, gridWidth_ * gridHeight_);
+
+    for (const Asteroid& ast : game.getAsteroids()) {
+      mark(grid, ast.getX(), ast.getY(), ast.getRadius(), OccupancyAsteroid);
+    }
+    for (const Bullet& bullet : game.getBullets()) {
+      mark(grid, bullet.getX(), bullet.getY(), 0, OccupancyBullet);
+    }
+    mark(grid, game.getPlayer().getX(), game.getPlayer().getY(), 10, OccupancyShip);
+  }
+}
+
+void VectorEnvironment::mark(uint8_t* grid, int x, int y, int radius, uint8_t bits) noexcept {
+  //Finds the cells under the square, clipped to the grid since asteroids
+  //can drift past the edge of the screen before they wrap around
+  int left = max(0, (x - radius) / gridCellSize_);
+  int right = min(gridWidth_ - 1, (x + radius) / gridCellSize_);
+  int top = max(0, (y - radius) / gridCellSize_);
+  int bottom = min(gridHeight_ - 1, (y + radius) / gridCellSize_);
+
+  for (int row = top; row <= bottom; row++) {
+    for (int column = left; column <= right; column++) {
+      grid[row * gridWidth_ + column] |= bits;
+    }
+  }
+}
@@ -0,0 +1,160 @@
+#ifndef ASTEROIDS_ENVIRONMENT_H
+#define ASTEROIDS_ENVIRONMENT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Game.h"
+
+namespace asteroids {
+
+/**
+ * The number of floats describing each entity in an observation:
+ * kind, x, y, radius, cos(direction) and sin(direction). Positions are
+ * divided by the screen size and radii by the size of the largest asteroid.
+ */
+constexpr int kEntityFeatures = 6;
+
+/** The kinds of entity written in the first feature of each entity */
+enum EntityKind {
+  /** Padding after the last entity */
+  EntityNone = 0,
+
+  /** The ship controlled by the agent, always the first entity */
+  EntityShip = 1,
+
+  /** An asteroid */
+  EntityAsteroid = 2,
+
+  /** A bullet fired by the ship */
+  EntityBullet = 3
+};
+
+/** Bits set in an occupancy grid cell for each kind of entity covering it */
+enum OccupancyBits : std::uint8_t {
+  OccupancyAsteroid = 1 << 0,
+  OccupancyBullet = 1 << 1,
+  OccupancyShip = 1 << 2
+};
+
+/**
+ * Runs a batch of headless asteroids games side by side for training agents.
+ * Each step applies one action per game, advances every game by a tick and
+ * writes the observations, rewards and done flags straight into buffers owned
+ * by the caller, so stepping never allocates or copies through temporaries.
+ *
+ * A game that ends is reset immediately with the next seed, so the observation
+ * written alongside a done flag is the first observation of the new game.
+ *
+ * @author Jai Aslam
+ */
+class VectorEnvironment {
+public:
+  /**
+  * Constructs the given number of headless games of the given size.
+  */
+  VectorEnvironment(/** The number of games run side by side */int count, /** The most entities written per game, extra bullets and asteroids are left out */int maxEntities, /** The size in pixels of an occupancy grid cell, 0 disables the grid */int gridCellSize = 0, /** The width of each game screen */int width = 640, /** The height of each game screen */int height = 480);
+
+  /**
+  * Destructs the games.
+  */
+  ~VectorEnvironment();
+
+  /**
+  * Sets the buffers that observations, rewards and done flags are written to.
+  * Each buffer holds the data of every game one after the other and must stay
+  * alive until it is replaced.
+  */
+  void bind(/** count * entityStride() floats */float* entities, /** count * gridWidth() * gridHeight() cells, or nullptr */std::uint8_t* grid, /** count floats */float* rewards, /** count flags */std::uint8_t* dones) noexcept;
+
+  /**
+  * Restarts every game. Game i is seeded with seed + i and later resets keep
+  * counting up from there, so a run is reproducible from its seed.
+  */
+  void reset(/** The seed of the first game */unsigned seed) noexcept;
+
+  /**
+  * Applies one action to each game and advances every game by one tick. The
+  * reward is the score gained during the tick.
+  */
+  void step(/** count combinations of Action flags */const std::uint8_t* actions) noexcept;
+
+  /**
+  * @returns the number of games run side by side.
+  */
+  int size() const noexcept;
+
+  /**
+  * @returns the number of floats in the entity observation of a single game.
+  */
+  int entityStride() const noexcept;
+
+  /**
+  * @returns the number of occupancy grid columns, 0 if the grid is disabled.
+  */
+  int gridWidth() const noexcept;
+
+  /**
+  * @returns the number of occupancy grid rows, 0 if the grid is disabled.
+  */
+  int gridHeight() const noexcept;
+
+  /**
+  * @returns the game with the given index.
+  */
+  const Game& game(/** The index of the game */int index) const noexcept;
+
+private:
+  /** Directions run from -5 to 5 radians so are offset by 5 to index the tables */
+  static constexpr int kDirectionOffset = 5;
+
+  /** The games being played, each one is headless */
+  std::vector<std::unique_ptr<Game>> games_;
+
+  /** The most entities written per game */
+  const int maxEntities_;
+
+  /** The size in pixels of an occupancy grid cell, 0 if the grid is disabled */
+  const int gridCellSize_;
+
+  /** The number of occupancy grid columns */
+  int gridWidth_ = 0;
+
+  /** The number of occupancy grid rows */
+  int gridHeight_ = 0;
+
+  /** The seed the next game to be reset is given */
+  unsigned nextSeed_ = 0;
+
+  /** The cosine of every direction an entity can face, offset by kDirectionOffset */
+  float cos_[11];
+
+  /** The sine of every direction an entity can face, offset by kDirectionOffset */
+  float sin_[11];
+
+  /** The caller's entity observation buffer */
+  float* entities_ = nullptr;
+
+  /** The caller's occupancy grid buffer */
+  std::uint8_t* grid_ = nullptr;
+
+  /** The caller's reward buffer */
+  float* rewards_ = nullptr;
+
+  /** The caller's done flag buffer */
+  std::uint8_t* dones_ = nullptr;
+
+  /**
+  * Writes the observation of the given game into the bound buffers.
+  */
+  void observe(/** The index of the game */int index) noexcept;
+
+  /**
+  * Sets the bits of every grid cell covered by the given square.
+  */
+  void mark(/** The grid of the game */std::uint8_t* grid, /** The x coordinate of the center */int x, /** The y coordinate of the center */int y, /** Half the width of the square */int radius, /** The bits to set */std::uint8_t bits) noexcept;
+};
+}
+
+#endif
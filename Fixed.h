@@ -0,0 +1,149 @@
+#ifndef ASTEROIDS_FIXED_H
+#define ASTEROIDS_FIXED_H
+
+#include <cstdint>
+
+namespace asteroids {
+
+/**
+ * A 16.16 fixed point number: 16 bits of whole pixels and 16 bits of
+ * fraction. Everything that moves keeps its position in fixed point so slow
+ * movement adds up over the ticks instead of being truncated away, and the
+ * arithmetic is plain integer arithmetic, which gives exactly the same
+ * results with every compiler, optimization level and thread count.
+ *
+ * @author Jai Aslam
+ */
+struct Fixed {
+  /** The number of fraction bits */
+  static constexpr int kFractionBits = 16;
+
+  /** The value scaled by 2^16 */
+  std::int32_t raw = 0;
+
+  /**
+  * @returns the fixed point number with the given scaled value.
+  */
+  static constexpr Fixed fromRaw(/** The value scaled by 2^16 */std::int32_t raw) noexcept {
+    return Fixed{raw};
+  }
+
+  /**
+  * @returns the fixed point number equal to the given whole number.
+  */
+  static constexpr Fixed fromInt(/** The whole number */int value) noexcept {
+    return Fixed{value * (1 << kFractionBits)};
+  }
+
+  /**
+  * @returns the nearest whole number, halves rounding up.
+  */
+  constexpr int round() const noexcept {
+    return (raw + (1 << (kFractionBits - 1))) >> kFractionBits;
+  }
+
+  constexpr Fixed& operator+=(Fixed other) noexcept {
+    raw += other.raw;
+    return *this;
+  }
+
+  constexpr Fixed& operator-=(Fixed other) noexcept {
+    raw -= other.raw;
+    return *this;
+  }
+
+  friend constexpr Fixed operator+(Fixed a, Fixed b) noexcept {
+    return Fixed{a.raw + b.raw};
+  }
+
+  friend constexpr Fixed operator-(Fixed a, Fixed b) noexcept {
+    return Fixed{a.raw - b.raw};
+  }
+
+  friend constexpr Fixed operator-(Fixed a) noexcept {
+    return Fixed{-a.raw};
+  }
+
+  friend constexpr Fixed operator*(Fixed a, int b) noexcept {
+    return Fixed{a.raw * b};
+  }
+
+  friend constexpr Fixed operator*(Fixed a, Fixed b) noexcept {
+    return Fixed{(std::int32_t) (((std::int64_t) a.raw * b.raw) >> kFractionBits)};
+  }
+
+  friend constexpr bool operator==(Fixed a, Fixed b) noexcept {
+    return a.raw == b.raw;
+  }
+
+  friend constexpr bool operator<(Fixed a, Fixed b) noexcept {
+    return a.raw < b.raw;
+  }
+
+  friend constexpr bool operator>(Fixed a, Fixed b) noexcept {
+    return a.raw > b.raw;
+  }
+};
+
+/**
+ * A position, velocity or direction made of two fixed point numbers.
+ *
+ * @author Jai Aslam
+ */
+struct FixedVector {
+  /** The x component */
+  Fixed x;
+
+  /** The y component */
+  Fixed y;
+
+  /**
+  * @returns the vector with the given whole number components.
+  */
+  static constexpr FixedVector fromInt(/** The x component */int x, /** The y component */int y) noexcept {
+    return FixedVector{Fixed::fromInt(x), Fixed::fromInt(y)};
+  }
+
+  constexpr FixedVector& operator+=(FixedVector other) noexcept {
+    x += other.x;
+    y += other.y;
+    return *this;
+  }
+
+  friend constexpr FixedVector operator+(FixedVector a, FixedVector b) noexcept {
+    return FixedVector{a.x + b.x, a.y + b.y};
+  }
+
+  friend constexpr FixedVector operator-(FixedVector a, FixedVector b) noexcept {
+    return FixedVector{a.x - b.x, a.y - b.y};
+  }
+
+  friend constexpr FixedVector operator*(FixedVector a, int b) noexcept {
+    return FixedVector{a.x * b, a.y * b};
+  }
+};
+
+/**
+ * @returns the unit vector pointing the given number of whole radians
+ * clockwise from the positive x axis, for angles from -6 to 6. Every angle
+ * in the game is a whole number of radians in that range, so the cosines and
+ * sines are a fixed table rather than libm calls whose last bit can differ
+ * between platforms.
+ */
+constexpr FixedVector unitVector(/** The angle in whole radians, from -6 to 6 */int radians) noexcept {
+  //round(cos(k) * 2^16) and round(sin(k) * 2^16) for k from -6 to 6
+  constexpr std::int32_t cosines[13] = {62926, 18590, -42837, -64880, -27273, 35409, 65536, 35409, -27273, -64880, -42837, 18590, 62926};
+  constexpr std::int32_t sines[13] = {18312, 62844, 49598, -9248, -59592, -55147, 0, 55147, 59592, 9248, -49598, -62844, -18312};
+  return FixedVector{Fixed::fromRaw(cosines[radians + 6]), Fixed::fromRaw(sines[radians + 6])};
+}
+
+/**
+ * @returns the given vector rotated the given number of whole radians clockwise.
+ */
+constexpr FixedVector rotate(/** The vector to rotate */FixedVector v, /** The angle in whole radians, from -6 to 6 */int radians) noexcept {
+  FixedVector unit = unitVector(radians);
+  return FixedVector{v.x * unit.x - v.y * unit.y, v.x * unit.y + v.y * unit.x};
+}
+}
+
+#endif
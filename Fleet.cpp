@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "Collision.h"
+#include "Fleet.h"
+#include "GameOptions.h"
+
+using namespace std;
+using namespace asteroids;
+
+Fleet::Fleet(int size, int width, int height, int asteroidStep, int bulletStep, int shipSize)
+  : width_(width), height_(height), asteroidStep_(asteroidStep), bulletStep_(bulletStep), shipSize_(shipSize), autopilot_(asteroidStep, shipSize) {
+
+  //Spreads the homes over an even grid across the screen
+  int columns = 1;
+  while (columns * columns < size) {
+    columns++;
+  }
+  int rows = (size + columns - 1) / max(columns, 1);
+  pilots_.reserve(size);
+  for (int i = 0; i < size; i++) {
+    SDL_Point home = {width_ * (i % columns + 1) / (columns + 1), height_ * (i / columns + 1) / (rows + 1)};
+    pilots_.push_back(Pilot{Ship(home.x, home.y, shipSize_), FixedVector::fromInt(home.x, home.y), home});
+  }
+
+  //Makes room for every bullet the ships can have on the screen at once
+  int bullets = size * Bullet::maxOnScreen(width_, height_, bulletStep_);
+  bullets_.reserve(bullets);
+  owners_.reserve(bullets);
+  spent_.reserve(bullets);
+  reset();
+}
+
+Fleet::~Fleet() {}
+
+void Fleet::reset() noexcept {
+  //Sends every ship home with a full set of lives
+  for (Pilot& pilot : pilots_) {
+    pilot.ship = Ship(pilot.home.x, pilot.home.y, shipSize_);
+    pilot.start = pilot.ship.getPosition();
+    pilot.score = 0;
+    pilot.lives = kLives;
+    pilot.respawn = 0;
+    pilot.grace = kGraceTicks;
+  }
+  bullets_.clear();
+  owners_.clear();
+}
+
+int Fleet::size() const noexcept {
+  //Returns the number of ships
+  return pilots_.size();
+}
+
+const vector<Pilot>& Fleet::pilots() const noexcept {
+  //Returns the ships
+  return pilots_;
+}
+
+void Fleet::fly(const SpatialGrid& index) noexcept {
+  for (unsigned i = 0; i < pilots_.size(); i++) {
+    Pilot& pilot = pilots_[i];
+    if (pilot.lives <= 0) {
+      continue;
+    }
+
+    //A ship which lost a life waits before it comes back home
+    if (pilot.respawn > 0) {
+      if (--pilot.respawn == 0) {
+        pilot.ship = Ship(pilot.home.x, pilot.home.y, shipSize_);
+        pilot.grace = kGraceTicks;
+      }
+      pilot.start = pilot.ship.getPosition();
+      continue;
+    }
+    if (pilot.grace > 0) {
+      pilot.grace--;
+    }
+
+    //Applies the autopilot's action the same way the game applies the player's
+    pilot.start = pilot.ship.getPosition();
+    unsigned action = autopilot_.decide(pilot.ship, index);
+    if (action & ActionRotateLeft) {
+      pilot.ship.updateAngle(-1);
+    }
+    if (action & ActionRotateRight) {
+      pilot.ship.updateAngle(1);
+    }
+    if (action & ActionThrust) {
+      pilot.ship.updatePosition(10);
+    }
+    if (action & ActionReverse) {
+      pilot.ship.updatePosition(-10);
+    }
+    if (action & ActionFire) {
+      SDL_Point front = pilot.ship.rotateAboutCenter(pilot.ship.getX() + 5, pilot.ship.getY(), pilot.ship.getAngle());
+      bullets_.push_back(Bullet(front.x, front.y, pilot.ship.getAngle()));
+      owners_.push_back(i);
+    }
+  }
+
+  //Removes the bullets that went off the screen and moves the rest
+  dropBullets([this](int j) { return !bullets_[j].bulletOnScreen(); });
+  for (auto& bullet : bullets_) {
+    bullet.updatePosition(bulletStep_);
+  }
+}
+
+int Fleet::collide(const SpatialGrid& index, vector<pair<int, int>>& hits) noexcept {
+  const vector<Asteroid>& asteroids = index.asteroids();
+  int tests = 0;
+  hits.clear();
+
+  //The list has room for every asteroid, so no query is ever cut short
+  nearby_.resize(asteroids.size());
+  int* nearby = nearby_.data();
+
+  //Each ship against the asteroids around its path, unless it wrapped, in
+  //which case only where it ended up counts
+  for (Pilot& pilot : pilots_) {
+    if (pilot.lives <= 0 || pilot.respawn > 0 || pilot.grace > 0) {
+      continue;
+    }
+    FixedVector shipEnd = pilot.ship.getPosition();
+    FixedVector shipStart = pilot.start;
+    FixedVector moved = shipEnd - shipStart;
+    if (abs(moved.x.round()) > width_ / 2 || abs(moved.y.round()) > height_ / 2) {
+      shipStart = shipEnd;
+      moved = FixedVector{};
+    }
+
+    //Asteroids are indexed where they ended up, so the search reaches as far
+    //as one could have come from as well as along the ship's path
+    int reach = shipSize_ + (max(abs(moved.x.round()), abs(moved.y.round())) + 1) / 2 + asteroidStep_ + 2;
+    int found = index.query((shipStart.x + shipEnd.x).round() / 2, (shipStart.y + shipEnd.y).round() / 2, reach, nearby, (int) nearby_.size());
+    for (int k = 0; k < found; k++) {
+      tests++;
+      const Asteroid& ast = asteroids[nearby[k]];
+      FixedVector astEnd = ast.getPosition();
+      FixedVector astStart = astEnd - ast.getHeading() * asteroidStep_;
+      if (timeOfImpact(shipStart - astStart, shipEnd - astEnd, ast.getRadius() + shipSize_) >= 0) {
+        pilot.lives--;
+        pilot.respawn = kRespawnTicks;
+        break;
+      }
+    }
+  }
+
+  //Each bullet against the asteroids around its path, keeping the earliest
+  //hit and on a tie the first asteroid
+  spent_.assign(bullets_.size(), 0);
+  int reach = (bulletStep_ + 1) / 2 + asteroidStep_ + 2;
+  for (unsigned j = 0; j < bullets_.size(); j++) {
+    FixedVector bulletEnd = bullets_[j].getPosition();
+    FixedVector bulletStart = bulletEnd - bullets_[j].getHeading() * bulletStep_;
+    int found = index.query((bulletStart.x + bulletEnd.x).round() / 2, (bulletStart.y + bulletEnd.y).round() / 2, reach, nearby, (int) nearby_.size());
+    int bestTime = -1;
+    int best = -1;
+    for (int k = 0; k < found; k++) {
+      tests++;
+      const Asteroid& ast = asteroids[nearby[k]];
+      FixedVector astEnd = ast.getPosition();
+      FixedVector astStart = astEnd - ast.getHeading() * asteroidStep_;
+      int time = timeOfImpact(bulletStart - astStart, bulletEnd - astEnd, ast.getRadius());
+      if (time >= 0 && (bestTime < 0 || time < bestTime || (time == bestTime && nearby[k] < best))) {
+        bestTime = time;
+        best = nearby[k];
+      }
+    }
+    if (best >= 0) {
+      hits.push_back({best, owners_[j]});
+      spent_[j] = 1;
+    }
+  }
+
+  //Bullets which hit something are used up
+  dropBullets([this](int j) { return spent_[j] != 0; });
+  return tests;
+}
+
+void Fleet::reserve(int asteroids) noexcept {
+  //Keeps checking and flying from growing their lists
+  nearby_.reserve(asteroids);
+  autopilot_.reserve(asteroids);
+}
+
+void Fleet::credit(int pilot, int points) noexcept {
+  //Adds to the pilot's score
+  pilots_[pilot].score += points;
+}
+
+void Fleet::capture(vector<Ship>& ships, vector<Bullet>& bullets) const {
+  //Copies only the ships which are on the screen
+  ships.clear();
+  for (const Pilot& pilot : pilots_) {
+    if (pilot.lives > 0 && pilot.respawn == 0) {
+      ships.push_back(pilot.ship);
+    }
+  }
+  bullets.assign(bullets_.begin(), bullets_.end());
+}
+
+template <typename Test>
+void Fleet::dropBullets(Test test) noexcept {
+  //Compacts the bullets and their owners together, keeping their order
+  unsigned kept = 0;
+  for (unsigned j = 0; j < bullets_.size(); j++) {
+    if (!test(j)) {
+      if (kept != j) {
+        bullets_[kept] = bullets_[j];
+        owners_[kept] = owners_[j];
+      }
+      kept++;
+    }
+  }
+  bullets_.erase(bullets_.begin() + kept, bullets_.end());
+  owners_.resize(kept);
+}
@@ -0,0 +1,168 @@
+#ifndef ASTEROIDS_FLEET_H
+#define ASTEROIDS_FLEET_H
+
+#include <utility>
+#include <vector>
+
+#include "Ship.h"
+#include "Asteroid.h"
+#include "Bullet.h"
+#include "Autopilot.h"
+#include "SpatialGrid.h"
+
+namespace asteroids {
+
+/**
+ * One of the fleet's ships along with everything that belongs to it alone.
+ */
+struct Pilot {
+  /** The ship */
+  Ship ship;
+
+  /** Where the ship was at the start of the tick, the start of its path */
+  FixedVector start;
+
+  /** Where the ship appears, at the start and after losing a life */
+  SDL_Point home;
+
+  /** The points the pilot has scored */
+  int score = 0;
+
+  /** The lives the pilot has left */
+  int lives = 0;
+
+  /** The ticks until a ship which lost a life flies again, 0 while it flies */
+  int respawn = 0;
+
+  /** The ticks after coming back during which the ship cannot be hit */
+  int grace = 0;
+};
+
+/**
+ * Ships flown by autopilots alongside the player's, for load testing and
+ * local multiplayer. Every ship has its own bullets, score and lives and
+ * they all share the game's asteroids.
+ *
+ * The ships and bullets are checked against the asteroids in a single pass
+ * over the game's spatial index once it holds where the asteroids are this
+ * tick. Each ship and bullet only looks at the asteroids in the cells its
+ * path crosses, so the cost grows with the number of ships and bullets
+ * rather than with those times the number of asteroids.
+ *
+ * A ship which hits an asteroid loses a life and comes back at its home a
+ * little later, leaving the asteroids for everyone else. A ship out of lives
+ * stays out.
+ *
+ * @author Jai Aslam
+ */
+class Fleet {
+public:
+  /**
+  * Constructs a fleet of the given number of ships spread over the screen.
+  */
+  Fleet(/** The number of ships */int size, /** The width of the screen */int width, /** The height of the screen */int height, /** How far an asteroid moves each tick */int asteroidStep, /** How far a bullet moves each tick */int bulletStep, /** The radius of a ship */int shipSize);
+
+  /**
+  * Destructs the fleet.
+  */
+  ~Fleet();
+
+  /**
+  * Brings every ship home with a full set of lives and no score or bullets.
+  */
+  void reset() noexcept;
+
+  /**
+  * @returns the number of ships in the fleet.
+  */
+  int size() const noexcept;
+
+  /**
+  * @returns the ships and what belongs to them.
+  */
+  const std::vector<Pilot>& pilots() const noexcept;
+
+  /**
+  * Lets each autopilot fly its ship for a tick, then moves the bullets and
+  * drops those which left the screen.
+  */
+  void fly(/** The index of the asteroids as they were at the end of the last tick */const SpatialGrid& index) noexcept;
+
+  /**
+  * Checks every ship and bullet against the asteroids near its path this
+  * tick. Ships which hit an asteroid lose a life and bullets which hit one
+  * are removed, with the asteroid each bullet hit first and the pilot who
+  * fired it written into the hits.
+  *
+  * @returns the number of collision tests run.
+  */
+  int collide(/** The index of the asteroids as they are after moving */const SpatialGrid& index, /** Receives each hit asteroid and who hit it */std::vector<std::pair<int, int>>& hits) noexcept;
+
+  /**
+  * Makes room to check against the given number of asteroids.
+  */
+  void reserve(/** The number of asteroids */int asteroids) noexcept;
+
+  /**
+  * Adds points to a pilot's score.
+  */
+  void credit(/** The pilot */int pilot, /** The points */int points) noexcept;
+
+  /**
+  * Copies the ships that are flying and every bullet, reusing the storage of the vectors.
+  */
+  void capture(/** Receives the ships */std::vector<Ship>& ships, /** Receives the bullets */std::vector<Bullet>& bullets) const;
+
+private:
+  /** The ticks a ship which lost a life stays away */
+  static constexpr int kRespawnTicks = 90;
+
+  /** The ticks a ship which came back cannot be hit */
+  static constexpr int kGraceTicks = 60;
+
+
+  /** The lives each ship starts with */
+  static constexpr int kLives = 3;
+
+  /** The width of the screen */
+  const int width_;
+
+  /** The height of the screen */
+  const int height_;
+
+  /** How far an asteroid moves each tick */
+  const int asteroidStep_;
+
+  /** How far a bullet moves each tick */
+  const int bulletStep_;
+
+  /** The radius of a ship */
+  const int shipSize_;
+
+  /** The ships */
+  std::vector<Pilot> pilots_;
+
+  /** Every ship's bullets */
+  std::vector<Bullet> bullets_;
+
+  /** The pilot who fired each bullet */
+  std::vector<int> owners_;
+
+  /** Whether each bullet hit something this tick */
+  std::vector<char> spent_;
+
+  /** The asteroids near the ship or bullet being checked, with room for every asteroid */
+  std::vector<int> nearby_;
+
+  /** Flies every ship */
+  Autopilot autopilot_;
+
+  /**
+  * Drops the bullets for which the given test is true, keeping the owners in step.
+  */
+  template <typename Test>
+  void dropBullets(/** Picks the bullets to drop by index */Test test) noexcept;
+};
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "FrameBudget.h"
+
+using namespace std;
+using namespace asteroids;
+
+FrameBudget::FrameBudget(uint64_t targetMicros) noexcept : targetMicros_(targetMicros) {}
+
+void FrameBudget::beginFrame() noexcept {
+  //Every phase is timed from the one before it, the first from here
+  frame_++;
+  mark_ = chrono::steady_clock::now();
+}
+
+void FrameBudget::endPhase(Phase phase) noexcept {
+  //Charges the phase with the time since the last mark
+  auto now = chrono::steady_clock::now();
+  double micros = chrono::duration<double, micro>(now - mark_).count();
+  mark_ = now;
+
+  //Smooths the cost so a single slow frame does not change the quality
+  average_[phase] += (micros - average_[phase]) / 8;
+}
+
+void FrameBudget::endFrame() noexcept {
+  if (targetMicros_ == 0) {
+    return;
+  }
+
+  //Works out what a frame costs on average at the current quality, where
+  //drawing only happens every other frame at the reduced rate
+  double drawing = average_[PhaseEntities] + average_[PhaseHud] + average_[PhasePresent];
+  if (quality_ == QualityReducedRate) {
+    drawing /= 2;
+  }
+  double cost = average_[PhaseSimulate] + drawing;
+
+  //Counts how long frames have been over the target, or well under it
+  if (cost > targetMicros_) {
+    overBudget_++;
+    underBudget_ = 0;
+  }
+  else if (cost < targetMicros_ / 2) {
+    underBudget_++;
+    overBudget_ = 0;
+  }
+  else {
+    overBudget_ = 0;
+    underBudget_ = 0;
+  }
+
+  //Steps the quality down after a run of slow frames and back up after a
+  //long run of fast ones, the gap between the two keeps it from flickering
+  if (overBudget_ >= kDegradeAfter && quality_ + 1 < kQualityCount) {
+    quality_ = static_cast<Quality>(quality_ + 1);
+    overBudget_ = 0;
+  }
+  else if (underBudget_ >= kRestoreAfter && quality_ > QualityFull) {
+    quality_ = static_cast<Quality>(quality_ - 1);
+    underBudget_ = 0;
+  }
+}
+
+FrameBudget::Quality FrameBudget::quality() const noexcept {
+  //Returns the current quality level
+  return quality_;
+}
+
+bool FrameBudget::shouldRender() const noexcept {
+  //At the reduced rate only even frames are drawn
+  return quality_ < QualityReducedRate || frame_ % 2 == 0;
+}
+
+bool FrameBudget::mayRenderHud() const noexcept {
+  //Once the text may go stale it is only rendered every so many frames
+  return quality_ < QualityStaleHud || frame_ % kStaleHudFrames == 0;
+}
+
+uint64_t FrameBudget::averageMicros(Phase phase) const noexcept {
+  //Returns the smoothed cost of the phase
+  return average_[phase];
+}
@@ -0,0 +1,129 @@
+#ifndef ASTEROIDS_FRAMEBUDGET_H
+#define ASTEROIDS_FRAMEBUDGET_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace asteroids {
+
+/**
+ * Measures how long each phase of a frame takes and lowers the drawing
+ * quality, one step at a time, while frames keep running over their target.
+ * Quality comes back one step at a time once there is plenty of headroom.
+ * Only drawing is ever degraded, the simulation always runs every tick.
+ *
+ * @author Jai Aslam
+ */
+class FrameBudget {
+public:
+  /** The phases of a frame, in the order they run */
+  enum Phase {
+    /** Advancing the simulation */
+    PhaseSimulate,
+
+    /** Drawing the ship, asteroids, bullets and particles */
+    PhaseEntities,
+
+    /** Drawing the score and lives */
+    PhaseHud,
+
+    /** Presenting the finished frame */
+    PhasePresent,
+
+    /** The number of phases */
+    kPhaseCount
+  };
+
+  /** The quality levels, from best to cheapest. Each includes the savings of the ones before it */
+  enum Quality {
+    /** Everything is drawn every frame */
+    QualityFull,
+
+    /** The score and lives text is rendered again at most every few frames */
+    QualityStaleHud,
+
+    /** Asteroids are drawn as their corner points instead of outlines */
+    QualitySimpleOutlines,
+
+    /** Only every other frame is drawn */
+    QualityReducedRate,
+
+    /** The number of quality levels */
+    kQualityCount
+  };
+
+  /**
+  * Constructs a budget aiming for frames no longer than the given target.
+  */
+  explicit FrameBudget(/** The target frame time in microseconds, 0 never degrades */std::uint64_t targetMicros) noexcept;
+
+  /**
+  * Starts timing a new frame.
+  */
+  void beginFrame() noexcept;
+
+  /**
+  * Ends the given phase, charging it with the time since the last phase ended.
+  */
+  void endPhase(/** The phase that just finished */Phase phase) noexcept;
+
+  /**
+  * Ends the frame and raises or lowers the quality based on how long frames
+  * have been taking.
+  */
+  void endFrame() noexcept;
+
+  /**
+  * @returns the current quality level.
+  */
+  Quality quality() const noexcept;
+
+  /**
+  * @returns whether the current frame should be drawn at all.
+  */
+  bool shouldRender() const noexcept;
+
+  /**
+  * @returns whether the score and lives text may be rendered again this frame.
+  */
+  bool mayRenderHud() const noexcept;
+
+  /**
+  * @returns the smoothed time the given phase takes in microseconds.
+  */
+  std::uint64_t averageMicros(/** The phase */Phase phase) const noexcept;
+
+private:
+  /** The number of frames in a row over the target before quality drops */
+  static constexpr int kDegradeAfter = 15;
+
+  /** The number of frames in a row well under the target before quality returns */
+  static constexpr int kRestoreAfter = 120;
+
+  /** How many frames apart the text may be rendered once it is allowed to go stale */
+  static constexpr int kStaleHudFrames = 30;
+
+  /** The target frame time in microseconds */
+  const std::uint64_t targetMicros_;
+
+  /** The current quality level */
+  Quality quality_ = QualityFull;
+
+  /** The number of frames started so far */
+  std::uint64_t frame_ = 0;
+
+  /** When the last phase ended */
+  std::chrono::steady_clock::time_point mark_;
+
+  /** The smoothed time each phase takes in microseconds */
+  double average_[kPhaseCount] = {0};
+
+  /** The number of frames in a row that ran over the target */
+  int overBudget_ = 0;
+
+  /** The number of frames in a row that ran well under the target */
+  int underBudget_ = 0;
+};
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef ASTEROIDS_FRAMESNAPSHOT_H
+#define ASTEROIDS_FRAMESNAPSHOT_H
+
+#include <vector>
+
+#include "Ship.h"
+#include "Asteroid.h"
+#include "Bullet.h"
+#include "ParticleSystem.h"
+#include "Metrics.h"
+
+namespace asteroids {
+
+/**
+ * An immutable copy of everything needed to draw one tick of the game. The
+ * simulation fills a snapshot at the end of each tick and the renderer draws
+ * it, so the two never read the same state. The vectors keep their storage
+ * between ticks, so refilling a snapshot does not allocate once warmed up.
+ *
+ * @author Jai Aslam
+ */
+struct FrameSnapshot {
+  /**
+  * Constructs an empty snapshot able to hold the given number of particles.
+  */
+  explicit FrameSnapshot(/** The most particles the snapshot holds */int particleCapacity)
+    : player(0, 0, 10), particles(particleCapacity) {}
+
+  /** The ship controlled by the player */
+  Ship player;
+
+  /** The asteroids on the screen */
+  std::vector<Asteroid> asteroids;
+
+  /** The bullets on the screen */
+  std::vector<Bullet> bullets;
+
+  /** The ships of the fleet which are on the screen */
+  std::vector<Ship> fleetShips;
+
+  /** The bullets of the fleet */
+  std::vector<Bullet> fleetBullets;
+
+  /** The debris and exhaust on the screen */
+  ParticleSystem particles;
+
+  /** The score at the end of the tick */
+  int score = 0;
+
+  /** The number of lives left at the end of the tick */
+  int lives = 0;
+
+  /** The level at the end of the tick */
+  int level = 0;
+
+  /** The counters gathered by the simulation up to the end of the tick */
+  TickStats stats;
+};
+}
+
+#endif
@@ -4,8 +4,13 @@
 #include <cstdlib>
 #include <time.h>
 #include <string>
+#include <chrono>
+#include <thread>
+#include <math.h>
+#include <numeric>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
+#include <unistd.h>
 
 #include "Game.h"
 #include "Ship.h"
@@ -16,12 +21,38 @@ using namespace asteroids;
 //A game starts with a ship in the center of the grid
 //3 lives
 //1 asteroids
-Game::Game(int width, int height)
-  : width_(width), height_(height), player_(Ship(width_/2, height_/2, 10)), score_(0), lives_(3), level_(1){
+Game::Game(int width, int height, const GameOptions& options)
+  : width_(width), height_(height), headless_(options.headless), spawnBudget_(options.spawnBudget), tickScale_(options.tickScale), kinetic_(options.kineticCollisions), bruteForce_(options.bruteForceCollisions), nativeHud_(options.nativeHud), sprites_(options.sprites),
+    windowWidth_(options.windowWidth > 0 ? options.windowWidth : width), windowHeight_(options.windowHeight > 0 ? options.windowHeight : height), spawnSafeRadius_(options.spawnSafeRadius), budget_(options.frameBudgetMicros), player_(Ship(width_/2, height_/2, kShipSize)),
+    shipStart_(player_.getPosition()), score_(0), lives_(3), level_(1),
+    random_(options.seed != 0 ? options.seed : time(NULL)), asteroidIndex_(width, height, kIndexCellSize), schedule_(kAsteroidSpeed * options.tickScale, kBulletSpeed * options.tickScale, kShipSize),
+    fleet_(options.fleetSize, width, height, kAsteroidSpeed * options.tickScale, kBulletSpeed * options.tickScale, kShipSize), autopiloted_(options.autopilot), autopilot_(kAsteroidSpeed * options.tickScale, kShipSize), placer_(width, height),
+    scene_(width, height, windowWidth_, windowHeight_, options.renderDivisor), particles_(options.headless ? 0 : kParticleCapacity),
+    frames_(options.headless ? 0 : kParticleCapacity) {
+
+  //Makes room for every bullet the ship can have on the screen at once, and
+  //for every one of them and the fleet's hitting something in the same tick
+  int bullets = Bullet::maxOnScreen(width, height, kBulletSpeed * tickScale_);
+  bullets_.reserve(bullets);
+  bulletHits_.reserve(bullets);
+  collidingAsteroids_.reserve(bullets);
+  collidingBullets_.reserve(bullets);
+  fleetHits_.reserve(fleet_.size() * bullets);
 
-  
   //Create a large initial asteroid with size 50
   spawnAsteroids(50);
+  asteroidIndex_.build(asteroids_);
+
+  //Starts publishing live statistics, headless games and servers included,
+  //the game runs fine without them
+  if (options.metrics) {
+    metrics_.open(Metrics::segmentName(getpid()).c_str());
+  }
+
+  //A headless game only runs the simulation so needs none of SDL
+  if (headless_) {
+    return;
+  }
 
   //Initialize SDL2
   if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
@@ -39,7 +70,7 @@ Game::Game(int width, int height)
   }  
 
   //Construct the screen window
-  window_ = SDL_CreateWindow("Asteroids", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width_, height_, SDL_WINDOW_SHOWN);
+  window_ = SDL_CreateWindow("Asteroids", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, windowWidth_, windowHeight_, SDL_WINDOW_SHOWN);
 
   //If the window could not be created for some reason displays the reason why
   if (!window_) {
@@ -47,8 +78,9 @@ Game::Game(int width, int height)
     throw domain_error(string("Unable to create the window due to: ") + SDL_GetError());
   }
 
-  //Constructs the renderer which will draw the game
-  renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_SOFTWARE);
+  //Constructs the renderer which will draw the game, able to draw into a
+  //texture if the game is drawn at a different resolution to the window
+  renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_SOFTWARE | (scene_.needed() || sprites_ ? SDL_RENDERER_TARGETTEXTURE : 0));
   
   //If the renderer could not be constructed for some reason displays the reason why
   if (!renderer_) {
@@ -56,8 +88,25 @@ Game::Game(int width, int height)
     throw domain_error(string("Unable to create the renderer due to: ") + SDL_GetError());
   }
 
-  //Initializes the font which will be used to draw the score and the number of lives
-  sans_ = TTF_OpenFont("Sans.ttf", 24);
+  //Creates the texture the game is drawn into before it is scaled up, and
+  //draws the ships and asteroids into the atlas if they are drawn from it
+  try {
+    scene_.open(renderer_);
+    if (sprites_) {
+      atlas_.open(renderer_, kShipSize);
+    }
+  }
+  catch (const domain_error&) {
+    close();
+    throw;
+  }
+
+  //Initializes the font which will be used to draw the score and the number of lives,
+  //at the size it ends up on the window when the text is drawn at full resolution
+  sans_ = TTF_OpenFont("Sans.ttf", nativeHud_ ? max((int) lround(24 * scene_.scale()), 1) : 24);
+
+  //Opens the audio device, the game plays silently if there is none
+  mixer_.open();
   
   //Clear the window?
   clearBackground();
@@ -68,14 +117,23 @@ Game::~Game() {
   close();
 }
 
-void Game::drawScoreAndLives() {
-  // Creates a surface with the text from the score 
-  SDL_Surface* surfaceScore = TTF_RenderText_Solid(sans_, ("Score: " + to_string(score_)).c_str(), {255, 255, 255});
-  
-  //Turns the surface into a texture
-  SDL_Texture* message = SDL_CreateTextureFromSurface(renderer_, surfaceScore);
-  //Frees the surface so we don't have a memory leak from it
-  free(surfaceScore);
+void Game::drawScoreAndLives(int score, int lives) {
+  //Renders the text again only when it changed, and only as often as the
+  //frame budget allows once the game is struggling to keep up
+  bool changed = score != hudScore_ || lives != hudLives_;
+  if (!scoreTexture_ || (changed && budget_.mayRenderHud())) {
+    // Creates a texture with the text from the score 
+    SDL_DestroyTexture(scoreTexture_);
+    scoreTexture_ = renderText("Score: " + to_string(score));
+
+    //Creates a texture with text from the number of lives left
+    SDL_DestroyTexture(livesTexture_);
+    livesTexture_ = renderText("Lives: " + to_string(lives));
+
+    hudScore_ = score;
+    hudLives_ = lives;
+    metrics_.stats().hudRenders++;
+  }
 
   //Constructs the rectangle that the message will live in. 
   SDL_Rect messageRect;
@@ -83,13 +141,6 @@ void Game::drawScoreAndLives() {
   messageRect.y = 0;
   messageRect.w = 50;
   messageRect.h = 50;
- 
-  //Constructs a surface with text from the number of lives left
-  SDL_Surface* surfaceLives = TTF_RenderText_Solid(sans_, ("Lives: " + to_string(lives_)).c_str(), {255, 255, 255});
-  
-  //Constrcts a texture from the surface and frees the surface
-  SDL_Texture* message2 = SDL_CreateTextureFromSurface(renderer_, surfaceLives);
-  free(surfaceLives);
 
   //Constructs the rectangle that the message will live in
   SDL_Rect messageRect2;
@@ -99,20 +150,20 @@ void Game::drawScoreAndLives() {
   messageRect2.h = 50;
   
   //Displays the score and the number of lives on the screen
-  SDL_RenderCopy(renderer_, message, NULL, &messageRect); 
-  SDL_RenderCopy(renderer_, message2, NULL, &messageRect2);
-
-   
+  messageRect = hudRect(messageRect);
+  messageRect2 = hudRect(messageRect2);
+  SDL_RenderCopy(renderer_, scoreTexture_, NULL, &messageRect); 
+  SDL_RenderCopy(renderer_, livesTexture_, NULL, &messageRect2);
 }
 
-void Game::drawGameOver() {
-  //Constructs the surface containing the text from the gameover screen 
-  SDL_Surface* surfaceGameOver = TTF_RenderText_Solid(sans_, ("Game Over, Score: " + to_string(score_)).c_str(), {255, 255, 255});
-  
-  //Creates a texture from the surface and frees the surface to
-  //prevent memory leaks
-  SDL_Texture* message = SDL_CreateTextureFromSurface(renderer_, surfaceGameOver);
-  free(surfaceGameOver);
+void Game::drawGameOver(int score) {
+  //Constructs the texture containing the text from the gameover screen,
+  //which only changes if the final score does
+  if (!gameOverTexture_ || score != gameOverScore_) {
+    SDL_DestroyTexture(gameOverTexture_);
+    gameOverTexture_ = renderText("Game Over, Score: " + to_string(score));
+    gameOverScore_ = score;
+  }
 
   //Constructs the rectangle that the gameover text will live in 
   SDL_Rect messageRect;
@@ -122,23 +173,74 @@ void Game::drawGameOver() {
   messageRect.h = 200;
  
   //Renders the game over message to the screen
-  SDL_RenderCopy(renderer_, message, NULL, &messageRect);   
+  messageRect = hudRect(messageRect);
+  SDL_RenderCopy(renderer_, gameOverTexture_, NULL, &messageRect);   
 }
 
+SDL_Rect Game::hudRect(const SDL_Rect& rect) const noexcept {
+  //Text drawn into the scene is scaled along with it
+  return nativeHud_ ? scene_.toWindow(rect) : rect;
+}
 
-void Game::spawnAsteroids(int radius) noexcept {
-  //Initializes random seed for number generator
-  srand(time(NULL));
-  
-  //Allows asteroids to spawn on each other for now  
-  for (auto i = 0; i < level_; i++) {
-    asteroids_.push_back(make_shared<Asteroid>(Asteroid(rand() % width_ + radius, rand() % height_ + radius, radius, rand() % 6 ))); 
+SDL_Texture* Game::renderText(const string& text) {
+  //Constructs the surface containing the text
+  SDL_Surface* surface = TTF_RenderText_Solid(sans_, text.c_str(), {255, 255, 255});
+  if (!surface) {
+    return nullptr;
   }
+
+  //Creates a texture from the surface and frees the surface to
+  //prevent memory leaks
+  SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
+  SDL_FreeSurface(surface);
+  return texture;
+}
+
+void Game::spawnAsteroids(int radius) noexcept {
+  //Runs the same script a wave does, all in one go, through the director so
+  //the game keeps its frame and the next level starts in it instead of
+  //allocating while other games on this thread hold the spare
+  reserveLevel();
+  avoidShips();
+  director_.stop();
+  director_.start(asteroidWave(level_, radius, placer_, random_));
+  director_.spawn(level_ + 1, asteroids_);
+}
+
+void Game::reset(unsigned seed) noexcept {
+  //Puts the ship back in the center with a full set of lives
+  player_ = Ship(width_/2, height_/2, kShipSize);
+  shipStart_ = player_.getPosition();
+  score_ = 0;
+  lives_ = 3;
+  level_ = 1;
+
+  //Clears the screen, keeping the storage so the next game does not allocate
+  director_.stop();
+  asteroids_.clear();
+  bullets_.clear();
+
+  //Restarts the random number generator and spawns the first level
+  schedule_.reset();
+  fleet_.reset();
+  random_.seed(seed);
+  spawnAsteroids(50);
+  asteroidIndex_.build(asteroids_);
+  indexStale_ = false;
 }
 
 void Game::close() noexcept {
-  //Destroy the renderer and window, and set the variables to nullptr
-  //to ensure idempotence
+  //Destroy the cached text, then the renderer and window, and set the
+  //variables to nullptr to ensure idempotence
+  for (SDL_Texture** texture : {&scoreTexture_, &livesTexture_, &gameOverTexture_}) {
+    if (*texture) {
+      SDL_DestroyTexture(*texture);
+      *texture = nullptr;
+    }
+  }
+
+  atlas_.close();
+  scene_.close();
   if (renderer_) {
     SDL_DestroyRenderer(renderer_);
     renderer_ = nullptr;
@@ -149,8 +251,19 @@ void Game::close() noexcept {
     window_ = nullptr;
   }
 
+  //A headless game never initialized any of SDL
+  if (headless_) {
+    return;
+  }
+
+  //Stops the audio before SDL goes away underneath it
+  mixer_.close();
+
   //Closes the font that was used to render text
-  TTF_CloseFont(sans_);
+  if (sans_) {
+    TTF_CloseFont(sans_);
+    sans_ = nullptr;
+  }
 
   //Quits out of true type font, images and sdl
   TTF_Quit();
@@ -161,60 +274,402 @@ void Game::close() noexcept {
 void Game::refresh() {
   //If we are still displaying to the screen
   if (renderer_) {
-    //Clear the background
-    clearBackground();
-
-    if (stillAlive()) {
-      //Draw the ship
-      player_.draw(renderer_);
-    
-      //Draws all of the asteroids currently on the screen
-      //Updates their position as well
-      for (auto asteroid : asteroids_) {
-        asteroid->draw(renderer_);
-        asteroid->updatePosition(2);
+    //Times the whole frame for the frame time histogram
+    auto frameStart = chrono::steady_clock::now();
+
+    //Moves everything on the screen while the player is still alive
+    budget_.beginFrame();
+    advance();
+    budget_.endPhase(FrameBudget::PhaseSimulate);
+
+    //Hands the tick to the renderer the same way the simulation thread does,
+    //though a game that is running behind does not draw every tick
+    captureSnapshot(frames_.back());
+    frames_.publish();
+    frames_.update();
+    if (budget_.shouldRender()) {
+      render(frames_.front());
+    }
+    budget_.endFrame();
+
+    //Publishes how long the frame took along with the rest of the statistics
+    auto frameTime = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - frameStart);
+    metrics_.recordFrame(frameTime.count());
+    publishMetrics(frames_.front());
+  }
+}
+
+void Game::runThreaded(int ticksPerSecond) {
+  //Starts the simulation on its own thread, actions are queued from now on
+  heldActions_ = 0;
+  simulating_ = true;
+  thread simulation(&Game::simulate, this, ticksPerSecond);
+
+  //Handles requests and draws the latest tick until the window is closed
+  while (isOpen()) {
+    processRequests();
+
+    //Waits a moment rather than drawing the same tick twice
+    if (!isOpen() || !frames_.update()) {
+      SDL_Delay(1);
+      continue;
+    }
+
+    //The simulation runs elsewhere so the frame is only spent drawing
+    auto frameStart = chrono::steady_clock::now();
+    budget_.beginFrame();
+    if (budget_.shouldRender()) {
+      render(frames_.front());
+    }
+    budget_.endFrame();
+    auto frameTime = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - frameStart);
+    metrics_.recordFrame(frameTime.count());
+    publishMetrics(frames_.front());
+  }
+
+  //Stops the simulation and waits for its last tick to finish, and only
+  //then closes SDL, which the tick may still have been using
+  simulating_ = false;
+  simulation.join();
+  close();
+}
+
+void Game::runClient(NetClient& client) {
+  //Actions are collected for the server from now on
+  client_ = &client;
+  const auto period = chrono::microseconds(1000000 / 60);
+  auto nextFrame = chrono::steady_clock::now();
+
+  while (isOpen()) {
+    //Sends what the player did this frame, even nothing, which also tells
+    //the server which state arrived last
+    processRequests();
+    if (!isOpen()) {
+      break;
+    }
+    client.send(remoteActions_);
+    remoteActions_ = 0;
+    client.receive();
+
+    //Draws the state the server sent, slid along to the current time
+    auto frameStart = chrono::steady_clock::now();
+    budget_.beginFrame();
+    if (client.interpolate(frames_.back())) {
+      frames_.publish();
+      frames_.update();
+      if (budget_.shouldRender()) {
+        render(frames_.front());
       }
-    
-      //Draws the bullets that the ship has fired if they are on screen
-      vector<int> bltIdxOffScreen;
-      for (unsigned i = 0; i < bullets_.size(); i++) {
-        if (bullets_.at(i)->bulletOnScreen()) {
-          bullets_.at(i)->draw(renderer_);
-          bullets_.at(i)->updatePosition(7);
-        }
+    }
+    budget_.endFrame();
+    auto frameTime = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - frameStart);
+    metrics_.recordFrame(frameTime.count());
+    publishMetrics(frames_.front());
+
+    //Draws at a steady rate rather than as fast as it can
+    nextFrame += period;
+    this_thread::sleep_until(nextFrame);
+  }
+  client_ = nullptr;
+  close();
+}
+
+bool Game::isOpen() const noexcept {
+  //The renderer is destroyed when the game is closed
+  return renderer_ != nullptr && !quitRequested_;
+}
+
+void Game::quit() noexcept {
+  //The loop running the game notices and closes it
+  quitRequested_ = true;
+}
+
+void Game::simulate(int ticksPerSecond) noexcept {
+  //Ticks are scheduled against the clock so a slow tick is caught up on
+  //rather than slowing the game down
+  const auto period = chrono::nanoseconds(1000000000 / ticksPerSecond);
+  auto nextTick = chrono::steady_clock::now();
+  InputCommand taken;
+
+  while (simulating_) {
+    //Applies the actions which happened before this tick was due. A tick
+    //running late leaves any that happened after for the tick they belong to
+    for (const InputCommand* command = commands_.peek(); command && command->time <= nextTick; command = commands_.peek()) {
+      applyAction(command->action);
+      commands_.pop(taken);
+    }
+
+    //Moves everything while the player is still alive and hands the result to the renderer
+    advance();
+    captureSnapshot(frames_.back());
+    frames_.publish();
+
+    //Sleeps until the next tick is due
+    nextTick += period;
+    this_thread::sleep_until(nextTick);
+  }
+}
+
+void Game::captureSnapshot(FrameSnapshot& snapshot) const noexcept {
+  //Copies the entities, reusing the storage the snapshot already has
+  snapshot.player = player_;
+  snapshot.asteroids = asteroids_;
+  snapshot.bullets = bullets_;
+  fleet_.capture(snapshot.fleetShips, snapshot.fleetBullets);
+  snapshot.particles.copyFrom(particles_);
+
+  //Copies what the score and lives text shows, along with the counters
+  snapshot.score = score_;
+  snapshot.lives = lives_;
+  snapshot.level = level_;
+  snapshot.stats = tickStats_;
+}
+
+void Game::render(FrameSnapshot& snapshot) {
+  AllocationScope scope(AllocationTracker::PhaseRender);
+
+  //Clear the background of the texture the game is drawn into, or of the
+  //window if it is drawn straight onto it
+  scene_.begin(renderer_);
+  clearBackground();
+
+  if (snapshot.lives > 0) {
+    //Draws the debris and exhaust underneath everything else
+    snapshot.particles.draw(renderer_);
+
+    if (sprites_) {
+      //Copies the ships and asteroids out of the atlas in one go
+      atlas_.clear();
+      atlas_.add(snapshot.player);
+      for (auto& ship : snapshot.fleetShips) {
+        atlas_.add(ship);
+      }
+      for (auto& asteroid : snapshot.asteroids) {
+        atlas_.add(asteroid);
+      }
+      atlas_.draw(renderer_);
+    }
+    else {
+      //Draw the ship, then the rest of the fleet
+      snapshot.player.draw(renderer_);
+      for (auto& ship : snapshot.fleetShips) {
+        ship.draw(renderer_);
+      }
+
+      //Draws all of the asteroids currently on the screen in green, just their
+      //corners if the game is struggling to keep up
+      asteroidLines_.clear();
+      for (auto& asteroid : snapshot.asteroids) {
+        asteroid.draw(asteroidLines_);
+      }
+      SDL_SetRenderDrawColor(renderer_, 0, 255, 0, 0);
+      asteroidLines_.draw(renderer_, budget_.quality() >= FrameBudget::QualitySimpleOutlines);
+    }
+
+    //Draws the bullets that the ship has fired if they are on screen
+    for (auto& bullet : snapshot.bullets) {
+      if (bullet.bulletOnScreen()) {
+        bullet.draw(renderer_);
+      }
+    }
+    for (auto& bullet : snapshot.fleetBullets) {
+      if (bullet.bulletOnScreen()) {
+        bullet.draw(renderer_);
+      }
+    }
+  }
+  budget_.endPhase(FrameBudget::PhaseEntities);
+
+  //Text drawn at the window's full resolution goes on after the game is
+  //scaled up, otherwise it is drawn and scaled up along with the game
+  if (nativeHud_) {
+    scene_.present(renderer_);
+    scene_.beginWindow(renderer_);
+  }
+  if (snapshot.lives > 0) {
+    //Display the current score and number of lives left
+    drawScoreAndLives(snapshot.score, snapshot.lives);
+  }
+  else {
+    //If the player no longer has lives then draw trhe game over screen
+    drawGameOver(snapshot.score);
+  }
+  if (!nativeHud_) {
+    scene_.present(renderer_);
+  }
+  budget_.endPhase(FrameBudget::PhaseHud);
 
-        else {
-          //Saves all the indices of the bullets that went off screen
-          bltIdxOffScreen.push_back(i);
+  //Displays the renderer info to the screen
+  SDL_RenderPresent(renderer_);
+  budget_.endPhase(FrameBudget::PhasePresent);
+}
+
+void Game::tick() noexcept {
+  //Instrumented builds count the tick's allocations against its budget
+  AllocationTracker::beginTick();
+
+  //Spawns the next few asteroids of a wave that is still arriving
+  {
+    AllocationScope scope(AllocationTracker::PhaseSpawn);
+    avoidShips();
+    director_.spawn(spawnBudget_, asteroids_);
+
+    //Predicts the collisions of the new asteroids and of the bullets fired since last tick
+    if (kinetic_) {
+      schedule_.track(asteroids_, bullets_, shipStart_, false);
+    }
+  }
+
+  {
+    AllocationScope scope(AllocationTracker::PhaseMove);
+
+    //The other ships decide where the asteroids were last tick, like the
+    //player does, then fly and fire
+    if (fleet_.size() > 0) {
+      fleet_.fly(asteroidIndex_);
+    }
+
+    //Updates the position of all of the asteroids, telling the schedule
+    //about any that wrapped around the screen
+    for (unsigned i = 0; i < asteroids_.size(); i++) {
+      FixedVector expected = asteroids_[i].getPosition() + asteroids_[i].getHeading() * (kAsteroidSpeed * tickScale_);
+      asteroids_[i].updatePosition(kAsteroidSpeed * tickScale_);
+      if (kinetic_ && !(asteroids_[i].getPosition().x == expected.x && asteroids_[i].getPosition().y == expected.y)) {
+        schedule_.wrapped(i);
+      }
+    }
+
+    //Indexes where the asteroids ended up, once, for this tick's collisions
+    //and the next tick's queries
+    asteroidIndex_.build(asteroids_);
+    indexStale_ = false;
+
+    //Removes all the bullets that went off the screen and moves the rest
+    if (kinetic_) {
+      for (int j = bullets_.size() - 1; j > -1; j--) {
+        if (!bullets_[j].bulletOnScreen()) {
+          schedule_.eraseBullet(j);
         }
       }
+    }
+    bullets_.erase(remove_if(bullets_.begin(), bullets_.end(), [](const Bullet& bullet) { return !bullet.bulletOnScreen(); }), bullets_.end());
+    for (auto& bullet : bullets_) {
+      bullet.updatePosition(kBulletSpeed * tickScale_);
+    }
 
-      //Checks about all of the collisions between bullets and asteroids
-      //as well as asteroids and the ship
+    //Moves and fades the debris and exhaust
+    particles_.update();
+  }
+
+  {
+    AllocationScope scope(AllocationTracker::PhaseCollide);
+
+    //Checks about all of the collisions between bullets and asteroids
+    //as well as asteroids and the ship
+    tickStats_.ticks++;
+    tickStats_.collisionTests = 0;
+    if (kinetic_) {
+      checkScheduledCollisions();
+    }
+    else {
       checkBulletAsteroidCollisions();
       checkShipAsteroidCollisions();
+    }
+    if (fleet_.size() > 0) {
+      checkFleetCollisions();
+    }
+  }
 
-      //Removes all the bullets that are off the screen from the ship
-      for (signed i = bltIdxOffScreen.size() - 1; i > -1 ; i--) {
-        bullets_.erase(bullets_.begin() + bltIdxOffScreen.at(i));
-      } 
-    
-      //If there are no asteroids left on the screen
-      if (asteroids_.size() == 0) {
-        //Increase the level and spawn new asteroids
-        level_ ++;
-        spawnAsteroids(50);
-      }
-        //Display the current score and number of lives left
-        drawScoreAndLives();
-     }
-     else {
-       //If the player no longer has lives then draw trhe game over screen
-       drawGameOver();
-     }
-      //Displays the renderer info to the screen
-      SDL_RenderPresent(renderer_);
+  //If there are no asteroids left on the screen and none still to arrive
+  if (asteroids_.size() == 0 && !director_.active()) {
+    //Increase the level and start the next wave
+    AllocationScope scope(AllocationTracker::PhaseSpawn);
+    level_ ++;
+    startWave();
+  }
+
+  //The ship's path next tick starts where it is now
+  shipStart_ = player_.getPosition();
+
+  //Indexes the asteroids again for the next tick's queries only if the
+  //collisions changed them
+  {
+    AllocationScope scope(AllocationTracker::PhaseMove);
+    refreshIndex();
+  }
+  AllocationTracker::endTick();
+
+  //Publishes what the simulation has allocated so far, which only
+  //instrumented builds count
+  AllocationTracker::Counts allocated = AllocationTracker::simulationCounts();
+  tickStats_.allocations = allocated.allocations;
+  tickStats_.allocatedBytes = allocated.bytes;
+}
+
+void Game::advance() noexcept {
+  //Moves everything while the player is still alive, with the autopilot
+  //steering through the same actions the keyboard sends
+  if (stillAlive()) {
+    if (autopiloted_) {
+      applyAction(autopilot_.decide(*this));
     }
+    tick();
+  }
+}
+
+void Game::applyAction(unsigned action) noexcept {
+  //Rotates the ship counter clockwise or clockwise
+  if (action & ActionRotateLeft) {
+    player_.updateAngle(-1);
+  }
+  if (action & ActionRotateRight) {
+    player_.updateAngle(1);
+  }
+
+  //Moves the ship forwards or backwards, blowing exhaust out behind it
+  if (action & ActionThrust) {
+    player_.updatePosition(10);
+    mixer_.play(SoundThrust, 128);
+    particles_.emitThrust(player_.getX(), player_.getY(), player_.getAngle());
+  }
+  if (action & ActionReverse) {
+    player_.updatePosition(-10);
+    mixer_.play(SoundThrust, 128);
+    particles_.emitThrust(player_.getX(), player_.getY(), player_.getAngle() + M_PI);
+  }
+
+  //Fires a bullet from the front of the ship
+  if (action & ActionFire) {
+    fireBullet();
+  }
+}
+
+void Game::sendAction(unsigned action) noexcept {
+  //A client only collects the actions for the server
+  if (client_) {
+    remoteActions_ |= action;
+    return;
+  }
+
+  //Without a simulation thread the action can be applied straight away
+  if (!simulating_) {
+    applyAction(action);
+    return;
+  }
+
+  //Otherwise it is stamped and queued for the simulation thread, unless
+  //earlier actions are still waiting for room, so the order is kept
+  auto now = chrono::steady_clock::now();
+  if (heldActions_ == 0 && commands_.push({action, now})) {
+    return;
+  }
+
+  //The queue is full, so the action is held along with any others until
+  //there is room rather than waiting on the simulation
+  if (heldActions_ == 0) {
+    heldTime_ = now;
+  }
+  heldActions_ |= action;
 }
 
 void Game::fireBullet() noexcept {
@@ -223,73 +678,226 @@ void Game::fireBullet() noexcept {
 
   //Adds a bullet to the list of bullets starting at the front of the
   //gun and heading in the direction the ship was pointing. 
-  bullets_.push_back(make_shared<Bullet>(Bullet(front.x, front.y, player_.getAngle())));
+  bullets_.push_back(Bullet(front.x, front.y, player_.getAngle()));
+  mixer_.play(SoundFire);
 
 }
 
 void Game::checkShipAsteroidCollisions() noexcept {
-  //Checks if any of the player is colliding with any of the asteroids
-  //if so restart the level and decrease the number of lives left. 
-  for (unsigned int i = 0; i < asteroids_.size(); i++) {
-    if (player_.collides(asteroids_.at(i))) {
-      asteroids_.clear();
-      level_--;
-      lives_--;
+  //The ship's path this tick, unless it wrapped around the screen, in which
+  //case only where it ended up counts
+  FixedVector shipEnd = player_.getPosition();
+  FixedVector shipStart = shipStart_;
+  FixedVector moved = shipEnd - shipStart;
+  if (abs(moved.x.round()) > width_ / 2 || abs(moved.y.round()) > height_ / 2) {
+    shipStart = shipEnd;
+    moved = FixedVector{};
+  }
+
+  //Asteroids are indexed where they ended up, so the search reaches as far
+  //as one could have come from as well as along the ship's path, which can
+  //be several moves long when a client sends more than one
+  int step = kAsteroidSpeed * tickScale_;
+  int reach = kShipSize + (abs(moved.x.round()) + abs(moved.y.round()) + 1) / 2 + step + 2;
+  int found = findNearby((shipStart.x + shipEnd.x).round() / 2, (shipStart.y + shipEnd.y).round() / 2, reach);
+
+  //Checks if the ship's path comes within reach of any asteroid's path,
+  //if so restart the level and decrease the number of lives left
+  for (int k = 0; k < found; k++) {
+    tickStats_.collisionTests++;
+    tickStats_.collisionTestsTotal++;
+    const Asteroid& ast = asteroids_[nearby_[k]];
+    FixedVector astEnd = ast.getPosition();
+    FixedVector astStart = astEnd - ast.getHeading() * (kAsteroidSpeed * tickScale_);
+    if (timeOfImpact(shipStart - astStart, shipEnd - astEnd, ast.getRadius() + kShipSize) >= 0) {
+      loseLife();
+      break;
     }
   }  
 }
 
+void Game::checkScheduledCollisions() noexcept {
+  //Only the pairs whose predicted windows have come due are tested, along
+  //with anything involving an asteroid that wrapped
+  FixedVector ship = player_.getPosition();
+  bool shipMoved = !(ship.x == shipStart_.x && ship.y == shipStart_.y);
+  bulletHits_.assign(bullets_.size(), {-1, -1});
+  int tests = schedule_.collect(asteroids_, bullets_, ship, !shipMoved, bulletHits_);
+  tickStats_.collisionTests += tests;
+  tickStats_.collisionTestsTotal += tests;
+  resolveBulletHits();
+
+  //A ship which moved has nothing predicted for its new path, so it is
+  //tested against the asteroids around it like it is without the schedule
+  if (shipMoved) {
+    checkShipAsteroidCollisions();
+  }
+  else if (schedule_.shipHit(asteroids_, ship)) {
+    loseLife();
+  }
+
+  //Predicts the collisions of the split pieces, the wrapped asteroids and the moved ship
+  schedule_.track(asteroids_, bullets_, ship, shipMoved);
+}
+
+void Game::loseLife() noexcept {
+  //Restarts the level with one less life
+  mixer_.play(SoundExplosion);
+  director_.stop();
+  asteroids_.clear();
+  indexStale_ = true;
+  if (kinetic_) {
+    schedule_.clearAsteroids();
+  }
+  level_--;
+  lives_--;
+}
+
 void Game::checkBulletAsteroidCollisions() noexcept {
+  //Finds the first asteroid each bullet's path runs into this tick, testing
+  //the path relative to each asteroid so fast bullets cannot skip over one,
+  //and on a tie the first asteroid
+  bulletHits_.assign(bullets_.size(), {-1, -1});
+  int step = kAsteroidSpeed * tickScale_;
+  int reach = (kBulletSpeed * tickScale_ + 1) / 2 + step + 2;
+  for (unsigned j = 0; j < bullets_.size(); j++) {
+    FixedVector bulletEnd = bullets_[j].getPosition();
+    FixedVector bulletStart = bulletEnd - bullets_[j].getHeading() * (kBulletSpeed * tickScale_);
+    int found = findNearby((bulletStart.x + bulletEnd.x).round() / 2, (bulletStart.y + bulletEnd.y).round() / 2, reach);
+    for (int k = 0; k < found; k++) {
+      tickStats_.collisionTests++;
+      tickStats_.collisionTestsTotal++;
+      const Asteroid& ast = asteroids_[nearby_[k]];
+      FixedVector astEnd = ast.getPosition();
+      FixedVector astStart = astEnd - ast.getHeading() * step;
+      int time = timeOfImpact(bulletStart - astStart, bulletEnd - astEnd, ast.getRadius());
+      pair<int, int>& hit = bulletHits_[j];
+      if (time >= 0 && (hit.first < 0 || time < hit.first || (time == hit.first && nearby_[k] < hit.second))) {
+        hit = {time, nearby_[k]};
+      }
+    }
+  }
+  resolveBulletHits();
+}
+
+void Game::resolveBulletHits() noexcept {
   //The asteroids and bullets that are colliding with
-  //one another
-  vector<int> collidingAsteroids;
-  vector<int> collidingBullets;
-  
-  //Runs through all the asteroids
-  for (unsigned i = 0; i < asteroids_.size(); i++) {
-   //Runs through all the bullets
-   for (unsigned j = 0; j < bullets_.size(); j++) {
-     //If there are any collisions between the asteroids and bullets then note which ones
-     if (asteroids_.at(i)->collides(bullets_.at(j))) {
-       collidingAsteroids.push_back(i);
-       if (find(collidingBullets.begin(), collidingBullets.end(), j) == collidingBullets.end()) {
-         collidingBullets.push_back(j);
-       }
-       break;
-     }
-   }
-  }
-
-  //Runs through all of the asteroids that are colliding
-  for (int ct = collidingAsteroids.size() - 1; ct > -1; ct--) {
-    //The current asteroid that is colliding with a bullet
-    auto currAst = asteroids_.at(collidingAsteroids.at(ct));
+  //one another, reusing last tick's storage
+  collidingAsteroids_.clear();
+  collidingBullets_.clear();
+  for (unsigned j = 0; j < bullets_.size(); j++) {
+    if (bulletHits_[j].first >= 0) {
+      collidingBullets_.push_back(j);
+      collidingAsteroids_.push_back(bulletHits_[j].second);
+    }
+  }
+
+  //An asteroid hit by several bullets only breaks once
+  sort(collidingAsteroids_.begin(), collidingAsteroids_.end());
+  collidingAsteroids_.erase(unique(collidingAsteroids_.begin(), collidingAsteroids_.end()), collidingAsteroids_.end());
 
+  //Runs through all of the asteroids that are colliding, last first so the
+  //earlier indices stay put
+  for (int ct = collidingAsteroids_.size() - 1; ct > -1; ct--) {
     //Updates the score based on the size of the asteroid that was destroyed
-    updateScore(currAst);
-
-    //If the asteroids are big enough make them break apart into 3 smaller asteroids traveling
-    //in random directions
-    if (currAst->getRadius()/2 > 10) {
-      asteroids_.push_back(make_shared<Asteroid>(Asteroid(currAst->getX() + (currAst->getRadius() / 2), currAst->getY(), currAst->getRadius()/2, rand() % 6)));
-      asteroids_.push_back(make_shared<Asteroid>(Asteroid(currAst->getX() - (currAst->getRadius() / 2), currAst->getY(), currAst->getRadius()/2, rand() % 6)));
-      asteroids_.push_back(make_shared<Asteroid>(Asteroid(currAst->getX(), currAst->getY() - (currAst->getRadius() / 2), currAst->getRadius()/2, rand() % 6)));
-    }
-    //Removes all the asteroids from the screen that were colliding with bullets
-    asteroids_.erase(asteroids_.begin() + collidingAsteroids.at(ct));
+    updateScore(asteroids_[collidingAsteroids_[ct]]);
+    breakAsteroid(collidingAsteroids_[ct]);
   }
 
   //Runs through all the bullets that are colliding with asteroids and removes
-  //them from the screen
-  for (int k = collidingBullets.size() - 1; k > -1; k--) {
-    bullets_.erase(bullets_.begin() + collidingBullets.at(k));
+  //them from the screen, last first so the earlier indices stay put
+  for (int k = collidingBullets_.size() - 1; k > -1; k--) {
+    if (kinetic_) {
+      schedule_.eraseBullet(collidingBullets_[k]);
+    }
+    bullets_.erase(bullets_.begin() + collidingBullets_.at(k));
   }
 }
 
-void Game::updateScore(shared_ptr<Asteroid> ast) noexcept {
+void Game::checkFleetCollisions() noexcept {
+  //Every ship and bullet of the fleet is checked against the asteroids
+  //around it in one pass, through the index built after they moved unless
+  //the player broke some since
+  refreshIndex();
+  int tests = fleet_.collide(asteroidIndex_, fleetHits_);
+  tickStats_.collisionTests += tests;
+  tickStats_.collisionTestsTotal += tests;
+
+  //An asteroid hit by several bullets breaks once, for whoever's bullet
+  //comes first, and the asteroids are broken last first so the earlier
+  //indices stay put
+  sort(fleetHits_.begin(), fleetHits_.end(), [](const pair<int, int>& a, const pair<int, int>& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+  fleetHits_.erase(unique(fleetHits_.begin(), fleetHits_.end(), [](const pair<int, int>& a, const pair<int, int>& b) { return a.first == b.first; }), fleetHits_.end());
+  for (const auto& [asteroid, pilot] : fleetHits_) {
+    fleet_.credit(pilot, 200 / asteroids_[asteroid].getRadius());
+    breakAsteroid(asteroid);
+  }
+}
+
+void Game::breakAsteroid(int index) noexcept {
+  //The asteroid being destroyed
+  Asteroid currAst = asteroids_[index];
+
+  //Throws out debris where the asteroid was, louder for bigger asteroids
+  particles_.emitExplosion(currAst.getX(), currAst.getY(), currAst.getRadius());
+  mixer_.play(SoundExplosion, min(255, currAst.getRadius() * 5));
+
+  //If the asteroids are big enough make them break apart into 3 smaller asteroids traveling
+  //in random directions
+  if (currAst.getRadius()/2 > 10) {
+    int half = currAst.getRadius() / 2;
+    addAsteroid(Asteroid(currAst.getX() + half, currAst.getY(), half, random_() % 6));
+    addAsteroid(Asteroid(currAst.getX() - half, currAst.getY(), half, random_() % 6));
+    addAsteroid(Asteroid(currAst.getX(), currAst.getY() - half, half, random_() % 6));
+  }
+  //Removes the asteroid from the screen
+  if (kinetic_) {
+    schedule_.eraseAsteroid(index);
+  }
+  asteroids_.erase(asteroids_.begin() + index);
+  indexStale_ = true;
+}
+
+void Game::refreshIndex() noexcept {
+  //The indices in the index only go out of date when asteroids go away
+  if (indexStale_) {
+    asteroidIndex_.build(asteroids_);
+    indexStale_ = false;
+  }
+}
+
+int Game::findNearby(int x, int y, int range) noexcept {
+  //The list has room for every asteroid, so no query is ever cut short
+  nearby_.resize(asteroids_.size());
+
+  //The reference tests every asteroid in order
+  if (bruteForce_) {
+    iota(nearby_.begin(), nearby_.end(), 0);
+    return nearby_.size();
+  }
+
+  //Otherwise only the asteroids around the point, through an index of where
+  //they are now
+  refreshIndex();
+  return asteroidIndex_.query(x, y, range, nearby_.data(), (int) nearby_.size());
+}
+
+void Game::avoidShips() noexcept {
+  //Keeps clear of where each ship is, or where it will come back
+  placer_.clearAvoided();
+  placer_.avoid(player_.getX(), player_.getY(), spawnSafeRadius_);
+  for (const Pilot& pilot : fleet_.pilots()) {
+    if (pilot.lives > 0) {
+      SDL_Point spot = pilot.respawn > 0 ? pilot.home : SDL_Point{pilot.ship.getX(), pilot.ship.getY()};
+      placer_.avoid(spot.x, spot.y, spawnSafeRadius_);
+    }
+  }
+}
+
+void Game::updateScore(const Asteroid& ast) noexcept {
   //Updates the score inversely proportional to the size of the asteroid
   //that was exploded
-  score_ += 200/ast->getRadius();
+  score_ += 200/ast.getRadius();
 }
 
 void Game::updateLives() noexcept {
@@ -302,6 +910,61 @@ bool Game::stillAlive() noexcept {
   return lives_ > 0; 
 }
 
+int Game::getScore() const noexcept {
+  //Returns the current score
+  return score_;
+}
+
+int Game::getLives() const noexcept {
+  //Returns the number of lives left
+  return lives_;
+}
+
+int Game::getLevel() const noexcept {
+  //Returns the current level
+  return level_;
+}
+
+int Game::getWidth() const noexcept {
+  //Returns the width of the screen
+  return width_;
+}
+
+int Game::getHeight() const noexcept {
+  //Returns the height of the screen
+  return height_;
+}
+
+const Ship& Game::getPlayer() const noexcept {
+  //Returns the ship controlled by the player
+  return player_;
+}
+
+const vector<Asteroid>& Game::getAsteroids() const noexcept {
+  //Returns the asteroids on the screen
+  return asteroids_;
+}
+
+const vector<Bullet>& Game::getBullets() const noexcept {
+  //Returns the bullets on the screen
+  return bullets_;
+}
+
+const Fleet& Game::getFleet() const noexcept {
+  //Returns the other ships
+  return fleet_;
+}
+
+const TickStats& Game::getTickStats() const noexcept {
+  //Returns the simulation counters
+  return tickStats_;
+}
+
+const SpatialGrid& Game::getAsteroidIndex() const noexcept {
+  //Returns the index of the asteroids
+  return asteroidIndex_;
+}
+
 void Game::processRequests() noexcept {
   //Remove one event from the queue
   SDL_Event event;
@@ -309,9 +972,11 @@ void Game::processRequests() noexcept {
     //The type determines what kind of request occurred
 
     switch (event.type) {
-    //The window was closed
+    //The window was closed, which only asks to close since the simulation
+    //thread may still be using SDL
     case SDL_QUIT:
-      close();
+      quit();
+      break;
     //Look for a keypress
     case SDL_KEYDOWN:
       //Check the SDLKey vals
@@ -319,29 +984,29 @@ void Game::processRequests() noexcept {
         //Checks if the player has pressed the left key
         //in this case rotate the ship counter clockwise 
         case SDLK_LEFT:
-          player_.updateAngle(-1);
+          sendAction(ActionRotateLeft);
           break;
         case SDLK_RIGHT:
           //Checks if the player has pressed the right key
           //in this case rotate the ship clockwise
-          player_.updateAngle(1);
+          sendAction(ActionRotateRight);
           break;
         //Checks if the player has pressed the up key if so 
         //moves the ship in the direction that its front is
         //facing
         case SDLK_UP:
-          player_.updatePosition(10);
+          sendAction(ActionThrust);
           break;
         //Checks if the player has pressed the down key if so
         //moves the ship in the opposite direction that its
         //front is facing.
         case SDLK_DOWN:
-          player_.updatePosition(-10);
+          sendAction(ActionReverse);
           break;
         //Checks if the player has pressed the space bar
         //if so fires a bullet. 
         case SDLK_SPACE:
-          fireBullet();
+          sendAction(ActionFire);
         default: 
           break;
       }
@@ -349,6 +1014,81 @@ void Game::processRequests() noexcept {
       break;
     }
   }
+
+  //Sends the actions which found the queue full once the simulation has made room
+  if (simulating_ && heldActions_ != 0 && commands_.push({heldActions_, heldTime_})) {
+    heldActions_ = 0;
+  }
+}
+
+void Game::startWave() noexcept {
+  reserveLevel();
+
+  //Frees the finished wave first so the new one can reuse its frame, then
+  //hands the wave to the director which spawns it over the next few ticks
+  director_.stop();
+  director_.start(asteroidWave(level_, 50, placer_, random_));
+}
+
+void Game::reserveLevel() noexcept {
+  //Growing ahead of time is left out of the tick's budget
+  AllocationScope scope(AllocationTracker::PhaseReserve);
+
+  //Each large asteroid can be in at most nine pieces at once, and a split
+  //briefly holds three pieces alongside the asteroid it came from
+  size_t needed = asteroids_.size() + level_ * 9 + 3;
+  asteroids_.reserve(needed);
+
+  //Indexing, placing and scheduling them needs as much room again
+  asteroidIndex_.reserve(needed);
+  placer_.reserve(level_);
+  fleet_.reserve(needed);
+  autopilot_.reserve(needed);
+  nearby_.reserve(needed);
+  if (kinetic_) {
+    schedule_.reserve(needed, bullets_.capacity());
+  }
+}
+
+void Game::addAsteroid(const Asteroid& ast) noexcept {
+  //The level made room for it when it started
+  asteroids_.push_back(ast);
+}
+
+void Game::publishMetrics() noexcept {
+  //Copies the state of the game as it is now into the statistics
+  MetricsBlock& stats = metrics_.stats();
+  stats.asteroids = asteroids_.size();
+  stats.bullets = bullets_.size();
+  stats.score = score_;
+  stats.level = level_;
+  stats.lives = lives_;
+  stats.ticks = tickStats_.ticks;
+  stats.collisionTests = tickStats_.collisionTests;
+  stats.collisionTestsTotal = tickStats_.collisionTestsTotal;
+  stats.allocations = tickStats_.allocations;
+  stats.allocatedBytes = tickStats_.allocatedBytes;
+  stats.quality = budget_.quality();
+
+  metrics_.publish();
+}
+
+void Game::publishMetrics(const FrameSnapshot& snapshot) noexcept {
+  //Copies the state of the game at the end of the tick into the statistics
+  MetricsBlock& stats = metrics_.stats();
+  stats.asteroids = snapshot.asteroids.size();
+  stats.bullets = snapshot.bullets.size();
+  stats.score = snapshot.score;
+  stats.level = snapshot.level;
+  stats.lives = snapshot.lives;
+  stats.ticks = snapshot.stats.ticks;
+  stats.collisionTests = snapshot.stats.collisionTests;
+  stats.collisionTestsTotal = snapshot.stats.collisionTestsTotal;
+  stats.allocations = snapshot.stats.allocations;
+  stats.allocatedBytes = snapshot.stats.allocatedBytes;
+  stats.quality = budget_.quality();
+
+  metrics_.publish();
 }
 
 void Game::clearBackground() {
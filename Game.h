@@ -3,9 +3,32 @@
 
 #include <vector>
 #include <algorithm>
+#include <random>
+#include <string>
+#include <atomic>
+#include <chrono>
 #include <SDL2/SDL_ttf.h>
 
 #include "Ship.h"
+#include "Metrics.h"
+#include "ParticleSystem.h"
+#include "FrameSnapshot.h"
+#include "TripleBuffer.h"
+#include "Mixer.h"
+#include "SpscQueue.h"
+#include "WaveDirector.h"
+#include "FrameBudget.h"
+#include "CollisionSchedule.h"
+#include "Fleet.h"
+#include "GameOptions.h"
+#include "SpatialGrid.h"
+#include "SceneTarget.h"
+#include "Autopilot.h"
+#include "NetClient.h"
+#include "LineBatch.h"
+#include "SpriteAtlas.h"
+#include "AllocationTracker.h"
+#include "Collision.h"
 
 class SDL_Window;
 class SDL_Renderer;
@@ -29,7 +52,7 @@ public:
   * destroy asteroids which are floating around. The default size of the screen is
   * set here as well. 
   */
-  Game(/** The width of the game screen */int width = 640, /** The height of the game screen */int height = 480);
+  Game(/** The width of the game screen */int width = 640, /** The height of the game screen */int height = 480, /** How the game runs */const GameOptions& options = GameOptions());
   
   /**
   * Destructs the Game object.
@@ -41,6 +64,12 @@ public:
   */
   void spawnAsteroids(/** The radius of the asteroids being spawned. */int radius) noexcept;
 
+  /**
+  * Starts a new game from the first level with the random number generator
+  * seeded so that the same seed and actions always play out the same way.
+  */
+  void reset(/** The seed for the random number generator */unsigned seed) noexcept;
+
   /**
   * Closes the game. Closes SDL libraries and TTF resources. 
   */
@@ -52,6 +81,66 @@ public:
   */
   void refresh(); 
 
+  /**
+  * Runs the game until the window is closed with the simulation on its own
+  * thread ticking at a fixed rate. The calling thread handles the user's
+  * requests and draws whichever tick the simulation finished last, so slow
+  * drawing never holds up the simulation and the other way around.
+  */
+  void runThreaded(/** The number of simulation ticks per second */int ticksPerSecond);
+
+  /**
+  * Runs the game until the window is closed as a client of a game served
+  * elsewhere. The player's actions go to the server instead of the ship and
+  * what is drawn is whatever the server sends back.
+  */
+  void runClient(/** The connection to the server */NetClient& client);
+
+  /**
+  * @returns whether the game window is still open and nobody asked to close it.
+  */
+  bool isOpen() const noexcept;
+
+  /**
+  * Asks the game to close, such as when the window's close button is pressed.
+  * Whatever is running the game closes it once the simulation has stopped,
+  * so SDL never goes away underneath a tick. Safe to call from any thread.
+  */
+  void quit() noexcept;
+
+  /**
+  * Advances the simulation by one tick without drawing anything. Moves the
+  * asteroids and bullets, handles collisions and starts the next level once
+  * every asteroid is destroyed.
+  */
+  void tick() noexcept;
+
+  /**
+  * Lets the autopilot pick the ship's actions if it is flying, then ticks the
+  * simulation while the player is still alive.
+  */
+  void advance() noexcept;
+
+  /**
+  * Copies the entity counts, score, level, lives and simulation counters as
+  * they are now into the statistics and publishes them, for games which are
+  * never drawn such as headless runs and servers.
+  */
+  void publishMetrics() noexcept;
+
+  /**
+  * Applies a combination of actions to the ship, the same way the keyboard does.
+  */
+  void applyAction(/** A combination of Action flags */unsigned action) noexcept;
+
+  /**
+  * Applies a combination of actions to the ship from the thread handling the
+  * user's requests. While the simulation runs on its own thread the actions
+  * are stamped with the time they happened and queued, then applied at the
+  * start of the first tick due after that time.
+  */
+  void sendAction(/** A combination of Action flags */unsigned action) noexcept;
+
   /**
   * Deals with all of the user interactions with the game such as moving
   * the ship and firing bullets. 
@@ -78,10 +167,60 @@ public:
   */
   void checkShipAsteroidCollisions() noexcept; 
 
+  /**
+  * Checks the collisions which the schedule predicted are due this tick,
+  * with the same results as checking every pair.
+  */
+  void checkScheduledCollisions() noexcept;
+
+  /**
+  * Breaks the asteroids and removes the bullets which the collision checks
+  * found hitting each other.
+  */
+  void resolveBulletHits() noexcept;
+
+  /**
+  * Takes a life after the ship hit an asteroid and restarts the level.
+  */
+  void loseLife() noexcept;
+
+  /**
+  * Checks the fleet's ships and bullets against the asteroids and breaks
+  * the asteroids its bullets hit, crediting whoever fired first.
+  */
+  void checkFleetCollisions() noexcept;
+
+  /**
+  * Destroys the asteroid at the given index with debris and sound, leaving
+  * three smaller pieces behind if it is big enough.
+  */
+  void breakAsteroid(/** The index of the asteroid */int index) noexcept;
+
+  /**
+  * Indexes the asteroids again if any were broken or cleared since they
+  * were last indexed.
+  */
+  void refreshIndex() noexcept;
+
+  /**
+  * Finds the asteroids whose outline comes within the given distance of a
+  * point through the index, or every asteroid in order when testing by
+  * brute force, into nearby_.
+  *
+  * @returns the number of asteroids found.
+  */
+  int findNearby(/** The x coordinate of the point */int x, /** The y coordinate of the point */int y, /** The distance from the point */int range) noexcept;
+
+  /**
+  * Keeps new asteroids away from the player's ship and every ship of the
+  * fleet which is flying or coming back.
+  */
+  void avoidShips() noexcept;
+
   /**
   * Updates the score based on the size of the given asteroid that was destroyed.
   */
-  void updateScore(/** The asteroid that was destroyed by the bullet */std::shared_ptr<Asteroid> ast) noexcept;
+  void updateScore(/** The asteroid that was destroyed by the bullet */const Asteroid& ast) noexcept;
 
   /**
   * Decreases the number of lives that the player has left. 
@@ -93,16 +232,96 @@ public:
   */
   bool stillAlive() noexcept;
 
+  /**
+  * @returns the current score.
+  */
+  int getScore() const noexcept;
+
+  /**
+  * @returns the number of lives left.
+  */
+  int getLives() const noexcept;
+
+  /**
+  * @returns the current level.
+  */
+  int getLevel() const noexcept;
+
+  /**
+  * @returns the width of the game screen.
+  */
+  int getWidth() const noexcept;
+
+  /**
+  * @returns the height of the game screen.
+  */
+  int getHeight() const noexcept;
+
+  /**
+  * @returns the ship controlled by the player.
+  */
+  const Ship& getPlayer() const noexcept;
+
+  /**
+  * @returns the asteroids which are on the screen.
+  */
+  const std::vector<Asteroid>& getAsteroids() const noexcept;
+
+  /**
+  * @returns the bullets which are on the screen.
+  */
+  const std::vector<Bullet>& getBullets() const noexcept;
+
+  /**
+  * @returns the index of the asteroids as they were at the end of the last tick.
+  */
+  const SpatialGrid& getAsteroidIndex() const noexcept;
+
+  /**
+  * @returns the ships flying alongside the player's.
+  */
+  const Fleet& getFleet() const noexcept;
+
+  /**
+  * @returns the simulation counters, such as the collision tests run.
+  */
+  const TickStats& getTickStats() const noexcept;
+
   /**
   * Draws the score and number of lives on the game board. 
   */
-  void drawScoreAndLives();
+  void drawScoreAndLives(/** The score to draw */int score, /** The number of lives to draw */int lives);
 
   /**
   * Draws the game over screen which includes the player's final score. 
   */
-  void drawGameOver();
+  void drawGameOver(/** The final score */int score);
+
+  /**
+  * Copies everything needed to draw the current tick into the given snapshot.
+  */
+  void captureSnapshot(/** The snapshot to fill */FrameSnapshot& snapshot) const noexcept;
+
+  /**
+  * Draws the given snapshot to the screen.
+  */
+  void render(/** The snapshot to draw */FrameSnapshot& snapshot);
 private:
+  /** The width and height of the cells of the asteroid index */
+  static constexpr int kIndexCellSize = 32;
+
+  /** The distance from the center of the ship to its front */
+  static constexpr int kShipSize = 10;
+
+  /** The pixels an asteroid moves in a normal tick */
+  static constexpr int kAsteroidSpeed = 2;
+
+  /** The pixels a bullet moves in a normal tick */
+  static constexpr int kBulletSpeed = 7;
+
+  /** The most debris and exhaust particles alive at once */
+  static constexpr int kParticleCapacity = 32768;
+
   /** The window which the game is being displayed on */
   SDL_Window* window_ = nullptr;
   
@@ -115,9 +334,45 @@ private:
   /** The height of the screen */
   const int height_ = 0;
 
+  /** Whether the game runs without any SDL subsystem */
+  const bool headless_ = false;
+
+  /** The most asteroids a new wave spawns in a single tick */
+  const int spawnBudget_ = 0;
+
+  /** How many normal ticks of movement each tick covers */
+  const int tickScale_ = 1;
+
+  /** Whether collisions are checked through the schedule instead of testing every pair */
+  const bool kinetic_ = false;
+
+  /** Whether the player's ship and bullets are tested against every asteroid instead of only the nearby ones */
+  const bool bruteForce_ = false;
+
+  /** Whether the text is drawn at the window's full resolution rather than the game's */
+  const bool nativeHud_ = true;
+
+  /** Whether the ships and asteroids are copied out of the atlas rather than drawn as outlines */
+  const bool sprites_ = false;
+
+  /** The width of the window */
+  const int windowWidth_ = 0;
+
+  /** The height of the window */
+  const int windowHeight_ = 0;
+
+  /** How far from the ship the edge of a newly spawned asteroid must stay */
+  const int spawnSafeRadius_ = 0;
+
+  /** Lowers the drawing quality while frames run over their target */
+  FrameBudget budget_;
+
   /** The ship controlled by the player */
   Ship player_;
 
+  /** Where the ship was at the end of the last tick, the start of its path this tick */
+  FixedVector shipStart_;
+
   /** The current score of the game */
   int score_;
   
@@ -128,19 +383,174 @@ private:
   int level_;
   
   /** The asteroids which are on the screen */
-  std::vector<std::shared_ptr<Asteroid>> asteroids_;
+  std::vector<Asteroid> asteroids_;
   
   /** The bullets which are on the screen */
-  std::vector<std::shared_ptr<Bullet>> bullets_;
+  std::vector<Bullet> bullets_;
+
+  /** Each bullet's earliest hit this tick as the time of impact and the asteroid, or -1 */
+  std::vector<std::pair<int, int>> bulletHits_;
+
+  /** The asteroids near the player's ship or bullet being checked, with room for every asteroid */
+  std::vector<int> nearby_;
+
+  /** The asteroids hit by a bullet during the current tick */
+  std::vector<int> collidingAsteroids_;
+
+  /** The bullets which hit an asteroid during the current tick */
+  std::vector<int> collidingBullets_;
+
+  /** Generates the positions and directions of new asteroids */
+  std::minstd_rand random_;
+
+  /** Finds the asteroids near a point without looking at every asteroid */
+  SpatialGrid asteroidIndex_;
+
+  /** Whether asteroids were broken or cleared since the index was built */
+  bool indexStale_ = false;
+
+  /** Predicts when pairs will collide so only the pairs due are tested */
+  CollisionSchedule schedule_;
+
+  /** The ships flying alongside the player's, sharing its asteroids */
+  Fleet fleet_;
+
+  /** The asteroids the fleet's bullets hit this tick and the pilots who fired them */
+  std::vector<std::pair<int, int>> fleetHits_;
+
+  /** Whether the autopilot flies the ship */
+  const bool autopiloted_ = false;
+
+  /** Flies the ship when the game is autopiloted */
+  Autopilot autopilot_;
+
+  /** Keeps new asteroids on the screen, off each other and away from the ship */
+  SpawnPlacer placer_;
+
+  /** Spawns the asteroids of each new level over several ticks */
+  WaveDirector director_;
+
+  /** Draws the game at a lower resolution than the window and scales it up */
+  SceneTarget scene_;
+
+  /** The debris of destroyed asteroids and the exhaust of the ship */
+  ParticleSystem particles_;
+
+  /** The outlines of the asteroids being drawn */
+  LineBatch asteroidLines_;
+
+  /** Every ship and asteroid shape, drawn once, for drawing from in sprite mode */
+  SpriteAtlas atlas_;
 
   /** The font which all of the text is rendered in */
   TTF_Font* sans_ = nullptr;
 
+  /** The rendered score text */
+  SDL_Texture* scoreTexture_ = nullptr;
+
+  /** The rendered lives text */
+  SDL_Texture* livesTexture_ = nullptr;
+
+  /** The rendered game over text */
+  SDL_Texture* gameOverTexture_ = nullptr;
+
+  /** The score the score text was rendered for */
+  int hudScore_ = -1;
+
+  /** The number of lives the lives text was rendered for */
+  int hudLives_ = -1;
+
+  /** The score the game over text was rendered for */
+  int gameOverScore_ = -1;
+
+  /** The live statistics published for external monitoring */
+  Metrics metrics_;
+
+  /** Plays the sound effects */
+  Mixer mixer_;
+
+  /** The counters gathered by the simulation */
+  TickStats tickStats_;
+
+  /** The snapshots passed from the simulation to the renderer */
+  TripleBuffer<FrameSnapshot> frames_;
+
+  /** Whether the simulation is running on its own thread */
+  std::atomic<bool> simulating_{false};
+
+  /** Whether the game was asked to close */
+  std::atomic<bool> quitRequested_{false};
+
+  /** An action from the thread handling the user's requests */
+  struct InputCommand {
+    /** A combination of Action flags */
+    unsigned action;
+
+    /** When the action happened */
+    std::chrono::steady_clock::time_point time;
+  };
+
+  /** The actions waiting for the simulation thread, oldest first */
+  SpscQueue<InputCommand, 256> commands_;
+
+  /** The actions which found the queue full, sent together once there is room */
+  unsigned heldActions_ = 0;
+
+  /** When the first of the held actions happened */
+  std::chrono::steady_clock::time_point heldTime_;
+
+  /** The connection to the server while the game runs as a client */
+  NetClient* client_ = nullptr;
+
+  /** The actions waiting to be sent to the server */
+  unsigned remoteActions_ = 0;
+
   /**
   * Clear the background to opaque black.
   */
   void clearBackground();
 
+  /**
+  * Renders the given text in white into a new texture.
+  */
+  SDL_Texture* renderText(/** The text to render */const std::string& text);
+
+  /**
+  * @returns where text placed at the given rectangle of the game is drawn,
+  * which is on the window when the text is drawn at its full resolution.
+  */
+  SDL_Rect hudRect(/** The rectangle in the game's coordinates */const SDL_Rect& rect) const noexcept;
+
+  /**
+  * Starts the wave of asteroids for the current level, first making room for
+  * every asteroid the wave could break into so spawning, splitting and
+  * checking them never has to allocate.
+  */
+  void startWave() noexcept;
+
+  /**
+  * Makes room for every asteroid the current level could break into, in the
+  * asteroids and in everything sized by them.
+  */
+  void reserveLevel() noexcept;
+
+  /**
+  * Adds an asteroid to the screen.
+  */
+  void addAsteroid(/** The asteroid to add */const Asteroid& ast) noexcept;
+
+  /**
+  * Copies the entity counts, score, level, lives and simulation counters of
+  * the given snapshot into the statistics and publishes them.
+  */
+  void publishMetrics(/** The snapshot that was just drawn */const FrameSnapshot& snapshot) noexcept;
+
+  /**
+  * Ticks the simulation at a fixed rate until the game is closed. Runs on the
+  * simulation thread.
+  */
+  void simulate(/** The number of simulation ticks per second */int ticksPerSecond) noexcept;
+
 };
 }
 
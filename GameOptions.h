@@ -0,0 +1,92 @@
+#ifndef ASTEROIDS_GAMEOPTIONS_H
+#define ASTEROIDS_GAMEOPTIONS_H
+
+namespace asteroids {
+
+/**
+ * The actions that can be applied to the ship in a single tick. Actions are
+ * bit flags so several of them can be combined, e.g. turning while firing.
+ */
+enum Action : unsigned {
+  /** Leaves the ship as it is */
+  ActionNone = 0,
+
+  /** Rotates the ship counter clockwise */
+  ActionRotateLeft = 1 << 0,
+
+  /** Rotates the ship clockwise */
+  ActionRotateRight = 1 << 1,
+
+  /** Moves the ship in the direction its front is facing */
+  ActionThrust = 1 << 2,
+
+  /** Moves the ship in the opposite direction its front is facing */
+  ActionReverse = 1 << 3,
+
+  /** Fires a bullet from the front of the ship */
+  ActionFire = 1 << 4
+};
+
+/** The number of distinct action combinations, every action is less than this */
+constexpr unsigned kActionCount = 1 << 5;
+
+/** The most normal ticks one tick may cover, when a bullet crosses most of the screen each tick */
+constexpr int kMaxTickScale = 64;
+
+/**
+ * Settings which change how a game runs without changing its rules.
+ *
+ * @author Jai Aslam
+ */
+struct GameOptions {
+  /** Runs the simulation without a window, renderer or any SDL subsystem */
+  bool headless = false;
+
+  /** Seeds the random number generator, 0 seeds it from the clock */
+  unsigned seed = 0;
+
+  /** The most asteroids a new wave spawns in a single tick */
+  int spawnBudget = 4;
+
+  /** The frame time in microseconds the drawing quality is lowered to stay within, 0 never lowers it */
+  int frameBudgetMicros = 16667;
+
+  /** Lets the autopilot fly the ship instead of the keyboard */
+  bool autopilot = false;
+
+  /** How many normal ticks of movement each tick covers, higher runs a game second in fewer ticks, at most kMaxTickScale */
+  int tickScale = 1;
+
+  /** How far from the ship the edge of a newly spawned asteroid must stay */
+  int spawnSafeRadius = 100;
+
+  /** Checks only the collisions predicted to be due each tick instead of testing every pair */
+  bool kineticCollisions = false;
+
+  /** Tests the player's ship and bullets against every asteroid instead of only the nearby ones, the reference the other checks are compared against */
+  bool bruteForceCollisions = false;
+
+  /** The width of the window, 0 makes it as wide as the game */
+  int windowWidth = 0;
+
+  /** The height of the window, 0 makes it as tall as the game */
+  int windowHeight = 0;
+
+  /** Draws the game this many times smaller than the window and scales it up, 1 draws at full resolution */
+  int renderDivisor = 1;
+
+  /** Draws the score, lives and game over text at the window's full resolution */
+  bool nativeHud = true;
+
+  /** The number of ships flown by autopilots alongside the player's, sharing its asteroids */
+  int fleetSize = 0;
+
+  /** Draws the ships and asteroids from shapes drawn once at startup instead of as outlines every frame */
+  bool sprites = false;
+
+  /** Publishes live statistics in a shared memory segment for MetricsReader to watch */
+  bool metrics = true;
+};
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include "LineBatch.h"
+
+using namespace std;
+using namespace asteroids;
+
+LineBatch::LineBatch() noexcept {}
+
+LineBatch::~LineBatch() {}
+
+void LineBatch::clear() noexcept {
+  //Keeps the storage for the next frame
+  points_.clear();
+  starts_.clear();
+}
+
+void LineBatch::add(const SDL_Point* points, int count) {
+  //Copies the outline onto the end of the buffer
+  starts_.push_back(points_.size());
+  points_.insert(points_.end(), points, points + count);
+}
+
+void LineBatch::addClosed(const SDL_Point* offsets, int count, int x, int y) {
+  //Places each corner around the point straight into the buffer
+  starts_.push_back(points_.size());
+  for (int i = 0; i < count; i++) {
+    points_.push_back({x + offsets[i].x, y + offsets[i].y});
+  }
+  points_.push_back({x + offsets[0].x, y + offsets[0].y});
+}
+
+void LineBatch::draw(SDL_Renderer* r, bool pointsOnly) const noexcept {
+  if (points_.empty()) {
+    return;
+  }
+
+  //Points need no joining so they all go in a single call
+  if (pointsOnly) {
+    SDL_RenderDrawPoints(r, points_.data(), points_.size());
+    return;
+  }
+
+  //Otherwise each outline is joined up on its own
+  for (unsigned i = 0; i < starts_.size(); i++) {
+    int end = i + 1 < starts_.size() ? starts_[i + 1] : points_.size();
+    SDL_RenderDrawLines(r, points_.data() + starts_[i], end - starts_[i]);
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef ASTEROIDS_LINEBATCH_H
+#define ASTEROIDS_LINEBATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace asteroids {
+
+/**
+ * Collects the outlines drawn in one colour during a frame so they are
+ * handed to SDL together. The points of every outline sit one after the
+ * other in one buffer that keeps its storage from frame to frame.
+ *
+ * @author Jai Aslam
+ */
+class LineBatch {
+public:
+  /**
+  * Constructs an empty batch.
+  */
+  LineBatch() noexcept;
+
+  /**
+  * Destructs the batch.
+  */
+  ~LineBatch();
+
+  /**
+  * Empties the batch, keeping its storage.
+  */
+  void clear() noexcept;
+
+  /**
+  * Adds an outline joining the given points in order.
+  */
+  void add(/** The points to join */const SDL_Point* points, /** The number of points */int count);
+
+  /**
+  * Adds a closed outline joining the given offsets in order around the
+  * given point, finishing back at the first.
+  */
+  void addClosed(/** The corners relative to the point */const SDL_Point* offsets, /** The number of corners */int count, /** The x coordinate of the point */int x, /** The y coordinate of the point */int y);
+
+  /**
+  * Draws every outline in the batch in the renderer's current colour.
+  */
+  void draw(/** The renderer to draw on */SDL_Renderer* r, /** Draws only the points, which is cheaper */bool pointsOnly) const noexcept;
+
+private:
+  /** The points of every outline */
+  std::vector<SDL_Point> points_;
+
+  /** Where each outline starts in points_ */
+  std::vector<int> starts_;
+};
+}
+
+#endif
@@ -1,6 +1,14 @@
 #include <iostream>
+#include <string>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+#include <thread>
 #include "Game.h"
 #include "Ship.h"
+#include "NetServer.h"
+#include "NetClient.h"
+#include "AllocationTracker.h"
 
 using namespace std;
 using namespace asteroids;
@@ -14,15 +22,187 @@ using namespace asteroids;
 
 /**
  * The main program for asteroids. Runs the asteroids game. 
+ * Pass --threaded to run the simulation on its own thread, --autopilot to let
+ * the autopilot fly the ship and --headless to run without a window. A headless
+ * game runs as fast as it can until the game is over or --ticks ticks have run,
+ * then prints how it went. --seed fixes the random number generator and
+ * --tick-scale N makes each tick cover N normal ticks of movement, up to 64.
+ * --safe-radius N keeps new asteroids at least N pixels from the ship.
+ * --kinetic checks only the collisions predicted to be due each tick and
+ * --brute-force tests the ship and its bullets against every asteroid, the
+ * reference both the kinetic and the default indexed checks should agree with.
+ * --window W H opens a window of the given size with the game scaled to fit it keeping its shape,
+ * --render-scale N draws the game N times smaller than the window and scales it up,
+ * and --low-res-hud draws the text at that lower resolution too.
+ * --ships N flies N more ships by autopilot alongside the player's.
+ * --sprites draws the ships and asteroids from a pre-drawn atlas instead of as outlines.
+ * --serve PORT runs a headless game for clients on the given UDP port and
+ * --connect PORT plays the game served on that port of --host, 127.0.0.1 by default.
+ * In builds with ASTEROIDS_TRACK_ALLOCATIONS defined, --allocation-budget N
+ * fails a headless run if any tick allocates more than N times, leaving out
+ * the room made up front for each level, and the report names the functions
+ * which allocated when linked with -rdynamic.
  *
  * @return The status code. Normal is 0 and 1 is bad. 
  */
-int main() {
+int main(int argc, char* argv[]) {
   try {
+    //Reads how the game should run from the arguments
+    bool threaded = false;
+    long long ticks = -1;
+    int servePort = -1;
+    int connectPort = -1;
+    string host = "127.0.0.1";
+    long long allocationBudget = -1;
+    GameOptions options;
+    for (int i = 1; i < argc; i++) {
+      string arg = argv[i];
+      if (arg == "--threaded") {
+        threaded = true;
+      }
+      else if (arg == "--autopilot") {
+        options.autopilot = true;
+      }
+      else if (arg == "--headless") {
+        options.headless = true;
+      }
+      else if (arg == "--ticks" && i + 1 < argc) {
+        ticks = stoll(argv[++i]);
+      }
+      else if (arg == "--seed" && i + 1 < argc) {
+        options.seed = stoul(argv[++i]);
+      }
+      else if (arg == "--tick-scale" && i + 1 < argc) {
+        options.tickScale = clamp(stoi(argv[++i]), 1, kMaxTickScale);
+      }
+      else if (arg == "--window" && i + 2 < argc) {
+        options.windowWidth = max(1, stoi(argv[++i]));
+        options.windowHeight = max(1, stoi(argv[++i]));
+      }
+      else if (arg == "--render-scale" && i + 1 < argc) {
+        options.renderDivisor = max(1, stoi(argv[++i]));
+      }
+      else if (arg == "--low-res-hud") {
+        options.nativeHud = false;
+      }
+      else if (arg == "--ships" && i + 1 < argc) {
+        options.fleetSize = max(0, stoi(argv[++i]));
+      }
+      else if (arg == "--sprites") {
+        options.sprites = true;
+      }
+      else if (arg == "--kinetic") {
+        options.kineticCollisions = true;
+      }
+      else if (arg == "--brute-force") {
+        options.bruteForceCollisions = true;
+      }
+      else if (arg == "--safe-radius" && i + 1 < argc) {
+        options.spawnSafeRadius = max(0, stoi(argv[++i]));
+      }
+      else if (arg == "--serve" && i + 1 < argc) {
+        servePort = stoi(argv[++i]);
+        options.headless = true;
+      }
+      else if (arg == "--connect" && i + 1 < argc) {
+        connectPort = stoi(argv[++i]);
+      }
+      else if (arg == "--host" && i + 1 < argc) {
+        host = argv[++i];
+      }
+      else if (arg == "--allocation-budget" && i + 1 < argc) {
+        allocationBudget = stoll(argv[++i]);
+        if (!AllocationTracker::kEnabled) {
+          throw invalid_argument("--allocation-budget needs a build with ASTEROIDS_TRACK_ALLOCATIONS defined");
+        }
+      }
+      else {
+        throw invalid_argument("Unknown argument: " + arg);
+      }
+    }
+
+    Game game(640, 480, options);
+    AllocationTracker::setBudget(allocationBudget);
+
+    //A server runs the game at 60 ticks a second and reports on its clients every second
+    if (servePort >= 0) {
+      NetServer server(servePort);
+      const auto period = chrono::nanoseconds(1000000000 / 60);
+      auto nextTick = chrono::steady_clock::now();
+      uint64_t lastBytes = 0;
+      for (long long ran = 0; ran != ticks; ran++) {
+        server.receive(game);
+        game.advance();
+        server.broadcast(game);
+        game.publishMetrics();
+
+        const NetServerStats& stats = server.stats();
+        if (stats.ticks % 60 == 0) {
+          uint64_t perClient = stats.clients > 0 ? (stats.bytesSent - lastBytes) / stats.clients : 0;
+          cout << "tick " << stats.ticks << ", clients: " << stats.clients << ", bytes/s per client: " << perClient
+               << ", network us/tick: " << stats.lastTickMicros << " (max " << stats.maxTickMicros << ")" << endl;
+          lastBytes = stats.bytesSent;
+        }
 
-    Game game;
+        nextTick += period;
+        this_thread::sleep_until(nextTick);
+      }
+      return 0;
+    }
+
+    //A client draws the game served elsewhere until the window is closed
+    if (connectPort >= 0) {
+      NetClient client(host.c_str(), connectPort);
+      game.runClient(client);
+      return 0;
+    }
+
+    //A headless game runs flat out and reports on how far it got
+    if (options.headless) {
+      auto start = chrono::steady_clock::now();
+      long long ran = 0;
+      while (game.stillAlive() && ran != ticks) {
+        game.advance();
+        game.publishMetrics();
+        ran++;
+      }
+      chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+      cout << "ticks: " << ran << endl;
+      cout << "score: " << game.getScore() << endl;
+      cout << "level: " << game.getLevel() << endl;
+      cout << "ticks/s: " << ran / elapsed.count() << endl;
+      cout << "collision tests: " << game.getTickStats().collisionTestsTotal << endl;
+
+      //Sums up how the rest of the fleet did
+      if (game.getFleet().size() > 0) {
+        int flying = 0;
+        long long fleetScore = 0;
+        for (const Pilot& pilot : game.getFleet().pilots()) {
+          flying += pilot.lives > 0;
+          fleetScore += pilot.score;
+        }
+        cout << "fleet: " << flying << " of " << game.getFleet().size() << " ships flying, " << fleetScore << " points" << endl;
+      }
+
+      //Instrumented builds say where the allocations came from and fail if
+      //any tick went over its budget
+      if (AllocationTracker::kEnabled) {
+        AllocationTracker::report(cout);
+        if (AllocationTracker::overBudgetTicks() > 0) {
+          cerr << AllocationTracker::overBudgetTicks() << " ticks went over the allocation budget of " << allocationBudget << endl;
+          return 1;
+        }
+      }
+      return 0;
+    }
+
+    //The threaded game runs until the window is closed
+    if (threaded) {
+      game.runThreaded(60);
+      return 0;
+    }
 
-    while (true) {
+    while (game.isOpen()) {
       game.processRequests();
       game.refresh();
     }
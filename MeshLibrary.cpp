@@ -0,0 +1,64 @@
+#include <math.h>
+#include <cstdint>
+#include <cstdlib>
+
+#include "MeshLibrary.h"
+
+using namespace std;
+using namespace asteroids;
+
+const MeshLibrary& MeshLibrary::shared() noexcept {
+  //Built the first time an asteroid asks for an outline
+  static const MeshLibrary library;
+  return library;
+}
+
+MeshLibrary::MeshLibrary() : radii_{12, 25, 50} {
+  //Each variant's corners sit at a random distance between three quarters
+  //and all of the radius, with the same seed every run so the outlines
+  //never change
+  uint32_t state = 0x2545F491;
+  double jag[kVariants][AsteroidMesh::kVertices];
+  for (auto& variant : jag) {
+    for (double& distance : variant) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      distance = 0.75 + 0.25 * (state % 1000) / 1000.0;
+    }
+  }
+
+  //Scales every variant for every size
+  for (int radius : radii_) {
+    for (auto& variant : jag) {
+      AsteroidMesh mesh;
+      for (int i = 0; i < AsteroidMesh::kVertices; i++) {
+        double angle = 2 * M_PI * i / AsteroidMesh::kVertices;
+        mesh.offsets[i].x = lround(radius * variant[i] * cos(angle));
+        mesh.offsets[i].y = lround(radius * variant[i] * sin(angle));
+      }
+      meshes_.push_back(mesh);
+    }
+  }
+}
+
+const AsteroidMesh& MeshLibrary::mesh(int radius, int variant) const noexcept {
+  //Looks up the variant scaled for the size closest to the radius
+  return meshes_[sizeOf(radius) * kVariants + abs(variant) % kVariants];
+}
+
+int MeshLibrary::sizeOf(int radius) const noexcept {
+  //Finds the size closest to the radius
+  unsigned size = 0;
+  for (unsigned i = 1; i < radii_.size(); i++) {
+    if (abs(radii_[i] - radius) < abs(radii_[size] - radius)) {
+      size = i;
+    }
+  }
+  return size;
+}
+
+const vector<int>& MeshLibrary::radii() const noexcept {
+  //Returns the sizes
+  return radii_;
+}
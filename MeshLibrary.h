@@ -0,0 +1,68 @@
+#ifndef ASTEROIDS_MESHLIBRARY_H
+#define ASTEROIDS_MESHLIBRARY_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace asteroids {
+
+/**
+ * The outline of an asteroid as offsets from its center, in pixels.
+ */
+struct AsteroidMesh {
+  /** The number of corners in every outline */
+  static constexpr int kVertices = 10;
+
+  /** The corners of the outline, going round the center */
+  SDL_Point offsets[kVertices];
+};
+
+/**
+ * The jagged outlines asteroids are drawn with. Every outline is built once,
+ * pre-scaled for each size of asteroid in the game, and shared by every
+ * asteroid drawn with it, so an asteroid only has to remember which outline
+ * it uses.
+ *
+ * @author Jai Aslam
+ */
+class MeshLibrary {
+public:
+  /** The number of different outlines for each size */
+  static constexpr int kVariants = 6;
+
+  /**
+  * @returns the library shared by every asteroid.
+  */
+  static const MeshLibrary& shared() noexcept;
+
+  /**
+  * @returns the outline of the given variant for an asteroid of the given
+  * radius, scaled for the closest size the library has.
+  */
+  const AsteroidMesh& mesh(/** The radius of the asteroid */int radius, /** Which outline, any number */int variant) const noexcept;
+
+  /**
+  * @returns the index into radii of the size closest to the given radius.
+  */
+  int sizeOf(/** The radius of the asteroid */int radius) const noexcept;
+
+  /**
+  * @returns the radii of the sizes the outlines are scaled for, smallest first.
+  */
+  const std::vector<int>& radii() const noexcept;
+
+private:
+  /** The radii of the sizes the outlines are scaled for, smallest first */
+  std::vector<int> radii_;
+
+  /** The outlines of each size one after the other */
+  std::vector<AsteroidMesh> meshes_;
+
+  /**
+  * Builds the outlines of every variant and size.
+  */
+  MeshLibrary();
+};
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "Metrics.h"
+
+using namespace std;
+using namespace asteroids;
+
+Metrics::Metrics() noexcept {
+  //Starts with every counter at zero and no segment attached
+  memset(&current_, 0, sizeof(current_));
+  current_.magic = kMetricsMagic;
+  current_.version = kMetricsVersion;
+  name_[0] = '\0';
+}
+
+Metrics::~Metrics() {
+  //Removes the segment so stale statistics are not left behind
+  close();
+}
+
+bool Metrics::open(const char* name) noexcept {
+  //Only one segment can be attached at a time
+  close();
+
+  //Creates the segment, refusing to take over one another game is publishing in
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd == -1) {
+    return false;
+  }
+
+  //Sizes the segment to hold the sequence counter and the statistics
+  if (ftruncate(fd, sizeof(Segment)) == -1) {
+    ::close(fd);
+    shm_unlink(name);
+    return false;
+  }
+
+  //Maps the segment, the descriptor is not needed once it is mapped
+  void* mapped = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    shm_unlink(name);
+    return false;
+  }
+
+  //Starts the sequence even, no publish is in progress
+  segment_ = static_cast<Segment*>(mapped);
+  segment_->sequence.store(0, memory_order_release);
+  strncpy(name_, name, sizeof(name_) - 1);
+  name_[sizeof(name_) - 1] = '\0';
+  publish();
+  return true;
+}
+
+void Metrics::close() noexcept {
+  //Unmaps and removes the segment, and clears the pointer to ensure idempotence
+  if (segment_) {
+    munmap(segment_, sizeof(Segment));
+    shm_unlink(name_);
+    segment_ = nullptr;
+  }
+}
+
+MetricsBlock& Metrics::stats() noexcept {
+  //Returns the statistics being gathered
+  return current_;
+}
+
+void Metrics::recordFrame(uint64_t micros) noexcept {
+  //Finds the power of two bucket the frame time falls into
+  int bucket = 0;
+  while (bucket < kFrameTimeBuckets - 1 && micros >= (uint64_t(2) << bucket)) {
+    bucket++;
+  }
+
+  current_.frameTimeHistogram[bucket]++;
+  current_.frameTimeSumMicros += micros;
+  current_.lastFrameMicros = micros;
+  current_.frames++;
+}
+
+void Metrics::publish() noexcept {
+  if (!segment_) {
+    return;
+  }
+
+  //Marks the block as being written by making the sequence odd. Only the
+  //game ever writes so a plain load is enough to find the current value.
+  uint64_t sequence = segment_->sequence.load(memory_order_relaxed);
+  segment_->sequence.store(sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  //Copies the statistics, readers that overlap this will see an odd or changed sequence
+  memcpy(&segment_->block, &current_, sizeof(current_));
+
+  //Marks the block as consistent again
+  segment_->sequence.store(sequence + 2, memory_order_release);
+}
+
+string Metrics::segmentName(long pid) {
+  //Every game has its own segment so two running at once never share one
+  return string(kMetricsSegment) + "." + to_string(pid);
+}
+
+MetricsBlock Metrics::read(const char* name) {
+  //Opens the segment the game created
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd == -1) {
+    throw domain_error(string("Unable to open the metrics segment ") + name + " due to: " + strerror(errno));
+  }
+
+  //Maps the segment read only, the reader never disturbs the game
+  void* mapped = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw domain_error(string("Unable to map the metrics segment due to: ") + strerror(errno));
+  }
+  const Segment* segment = static_cast<const Segment*>(mapped);
+
+  //Retries until a copy is taken which no publish overlapped
+  MetricsBlock block;
+  uint64_t before;
+  uint64_t after;
+  do {
+    before = segment->sequence.load(memory_order_acquire);
+    memcpy(&block, &segment->block, sizeof(block));
+    atomic_thread_fence(memory_order_acquire);
+    after = segment->sequence.load(memory_order_relaxed);
+  } while ((before & 1) != 0 || before != after);
+
+  munmap(mapped, sizeof(Segment));
+
+  //Refuses to interpret a segment that was written by something else
+  if (block.magic != kMetricsMagic || block.version != kMetricsVersion) {
+    throw domain_error(string("The segment ") + name + " does not hold asteroids statistics");
+  }
+  return block;
+}
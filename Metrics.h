@@ -0,0 +1,195 @@
+#ifndef ASTEROIDS_METRICS_H
+#define ASTEROIDS_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace asteroids {
+
+/**
+ * The start of the name of the shared memory segment a game publishes its
+ * statistics in. Each game adds its process id, see Metrics::segmentName.
+ */
+constexpr const char* kMetricsSegment = "/asteroids_metrics";
+
+/** Identifies a mapped segment as an asteroids statistics block. */
+constexpr std::uint32_t kMetricsMagic = 0x41535452;
+
+/** The layout version of the statistics block. Bumped whenever a field changes. */
+constexpr std::uint32_t kMetricsVersion = 2;
+
+/**
+ * Number of buckets in the frame time histogram. Bucket i counts the frames
+ * which took less than 2^(i+1) microseconds, the last bucket counts everything slower.
+ */
+constexpr int kFrameTimeBuckets = 16;
+
+/**
+ * A plain snapshot of the live statistics of a running game. This is the
+ * payload which is copied into shared memory, so it only holds fixed size fields.
+ */
+struct MetricsBlock {
+  /** Always kMetricsMagic once the game has published at least once */
+  std::uint32_t magic;
+
+  /** The layout version, always kMetricsVersion */
+  std::uint32_t version;
+
+  /** The number of simulation ticks run so far */
+  std::uint64_t ticks;
+
+  /** The number of frames refreshed so far */
+  std::uint64_t frames;
+
+  /** The number of frames that landed in each frame time bucket */
+  std::uint64_t frameTimeHistogram[kFrameTimeBuckets];
+
+  /** The total time spent in all frames in microseconds */
+  std::uint64_t frameTimeSumMicros;
+
+  /** The time the last frame took in microseconds */
+  std::uint64_t lastFrameMicros;
+
+  /** The number of asteroids currently alive */
+  std::uint32_t asteroids;
+
+  /** The number of bullets currently alive */
+  std::uint32_t bullets;
+
+  /** The number of collision tests run during the last tick */
+  std::uint64_t collisionTests;
+
+  /** The number of collision tests run since the game started */
+  std::uint64_t collisionTestsTotal;
+
+  /** The current score */
+  std::int32_t score;
+
+  /** The current level */
+  std::int32_t level;
+
+  /** The current number of lives left */
+  std::int32_t lives;
+
+  /** The number of heap allocations made by the simulation, counted only by instrumented builds */
+  std::uint64_t allocations;
+
+  /** The number of bytes the simulation allocated, counted only by instrumented builds */
+  std::uint64_t allocatedBytes;
+
+  /** The number of times the score and lives text was rendered */
+  std::uint64_t hudRenders;
+
+  /** The drawing quality level, 0 is full quality and higher levels draw less */
+  std::uint32_t quality;
+};
+
+/**
+ * The counters gathered by the simulation as it ticks. They are kept apart
+ * from the rest of the statistics so they can travel with a frame snapshot to
+ * whichever thread publishes them.
+ */
+struct TickStats {
+  /** The number of simulation ticks run so far */
+  std::uint64_t ticks = 0;
+
+  /** The number of collision tests run during the last tick */
+  std::uint64_t collisionTests = 0;
+
+  /** The number of collision tests run since the game started */
+  std::uint64_t collisionTestsTotal = 0;
+
+  /** The number of heap allocations made by the simulation, counted only by instrumented builds */
+  std::uint64_t allocations = 0;
+
+  /** The number of bytes the simulation allocated, counted only by instrumented builds */
+  std::uint64_t allocatedBytes = 0;
+};
+
+/**
+ * Publishes the statistics of a running game into a POSIX shared memory segment
+ * so they can be watched from another process. The segment is guarded by a
+ * sequence lock: the game never waits on a reader, readers simply retry when
+ * they raced with a publish.
+ *
+ * @author Jai Aslam
+ */
+class Metrics {
+public:
+  /**
+  * Constructs a metrics publisher which is not attached to any segment yet.
+  * Until open is called every publish is ignored.
+  */
+  Metrics() noexcept;
+
+  /**
+  * Unmaps and removes the shared memory segment.
+  */
+  ~Metrics();
+
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+
+  /**
+  * Creates the shared memory segment with the given name and maps it. A
+  * segment which already exists belongs to another game and is left alone.
+  * If the segment cannot be created the game keeps running without publishing.
+  *
+  * @returns whether the segment was mapped.
+  */
+  bool open(/** The name of the segment, e.g. from segmentName */const char* name) noexcept;
+
+  /**
+  * Unmaps and removes the shared memory segment. Safe to call more than once.
+  */
+  void close() noexcept;
+
+  /**
+  * @returns the statistics being gathered for the next publish.
+  */
+  MetricsBlock& stats() noexcept;
+
+  /**
+  * Adds a finished frame to the frame time histogram.
+  */
+  void recordFrame(/** How long the frame took in microseconds */std::uint64_t micros) noexcept;
+
+  /**
+  * Copies the gathered statistics into the shared memory segment.
+  */
+  void publish() noexcept;
+
+  /**
+  * @returns the name of the segment the game in the given process publishes in.
+  */
+  static std::string segmentName(/** The process id of the game */long pid);
+
+  /**
+  * Reads a consistent copy of the statistics from the segment with the given name.
+  * Throws a domain_error if the segment does not exist or is not a statistics block.
+  */
+  static MetricsBlock read(/** The name of the segment to read */const char* name);
+
+private:
+  /** The layout of the shared memory segment */
+  struct Segment {
+    /** Odd while a publish is in progress, bumped twice per publish */
+    std::atomic<std::uint64_t> sequence;
+
+    /** The last published statistics */
+    MetricsBlock block;
+  };
+
+  /** The statistics being gathered by the game */
+  MetricsBlock current_;
+
+  /** The mapped segment or nullptr if publishing is disabled */
+  Segment* segment_ = nullptr;
+
+  /** The name the segment was created with, needed to remove it again */
+  char name_[64];
+};
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cctype>
+#include <stdexcept>
+#include <vector>
+#include <dirent.h>
+
+#include "Metrics.h"
+
+using namespace std;
+using namespace asteroids;
+
+/**
+ * Prints the statistics in a human readable form.
+ */
+static void printPlain(/** The statistics to print */const MetricsBlock& block) {
+  cout << "ticks:                 " << block.ticks << endl;
+  cout << "frames:                " << block.frames << endl;
+  cout << "last frame (us):       " << block.lastFrameMicros << endl;
+  cout << "asteroids:             " << block.asteroids << endl;
+  cout << "bullets:               " << block.bullets << endl;
+  cout << "collision tests/tick:  " << block.collisionTests << endl;
+  cout << "collision tests total: " << block.collisionTestsTotal << endl;
+  cout << "score:                 " << block.score << endl;
+  cout << "level:                 " << block.level << endl;
+  cout << "lives:                 " << block.lives << endl;
+  cout << "allocations:           " << block.allocations << endl;
+  cout << "allocated bytes:       " << block.allocatedBytes << endl;
+  cout << "hud renders:           " << block.hudRenders << endl;
+  cout << "quality level:         " << block.quality << endl;
+
+  //Prints every non empty bucket of the frame time histogram
+  cout << "frame time histogram:" << endl;
+  for (int i = 0; i < kFrameTimeBuckets; i++) {
+    if (block.frameTimeHistogram[i] != 0) {
+      if (i == kFrameTimeBuckets - 1) {
+        cout << "  >= " << (1ull << i) << " us: ";
+      }
+      else {
+        cout << "  < " << (2ull << i) << " us: ";
+      }
+      cout << block.frameTimeHistogram[i] << endl;
+    }
+  }
+}
+
+/**
+ * Prints a single metric in the Prometheus text exposition format.
+ */
+static void printMetric(/** The name of the metric */const char* name, /** Either counter or gauge */const char* type, /** What the metric measures */const char* help, /** The value of the metric */long long value) {
+  cout << "# HELP asteroids_" << name << " " << help << "\n";
+  cout << "# TYPE asteroids_" << name << " " << type << "\n";
+  cout << "asteroids_" << name << " " << value << "\n";
+}
+
+/**
+ * Prints the statistics in the Prometheus text exposition format.
+ */
+static void printPrometheus(/** The statistics to print */const MetricsBlock& block) {
+  printMetric("ticks_total", "counter", "Simulation ticks run.", block.ticks);
+  printMetric("asteroids", "gauge", "Asteroids currently alive.", block.asteroids);
+  printMetric("bullets", "gauge", "Bullets currently alive.", block.bullets);
+  printMetric("collision_tests", "gauge", "Collision tests run during the last tick.", block.collisionTests);
+  printMetric("collision_tests_total", "counter", "Collision tests run.", block.collisionTestsTotal);
+  printMetric("score", "gauge", "Current score.", block.score);
+  printMetric("level", "gauge", "Current level.", block.level);
+  printMetric("lives", "gauge", "Lives left.", block.lives);
+  printMetric("allocations_total", "counter", "Heap allocations made by the simulation.", block.allocations);
+  printMetric("allocated_bytes_total", "counter", "Bytes allocated by the simulation.", block.allocatedBytes);
+  printMetric("hud_renders_total", "counter", "Times the score and lives text was rendered.", block.hudRenders);
+  printMetric("quality_level", "gauge", "Drawing quality level, 0 is full quality.", block.quality);
+
+  //Prometheus histograms are cumulative and bucketed by their upper bound
+  cout << "# HELP asteroids_frame_time_microseconds Time taken by each frame.\n";
+  cout << "# TYPE asteroids_frame_time_microseconds histogram\n";
+  unsigned long long cumulative = 0;
+  for (int i = 0; i < kFrameTimeBuckets - 1; i++) {
+    cumulative += block.frameTimeHistogram[i];
+    cout << "asteroids_frame_time_microseconds_bucket{le=\"" << (2ull << i) << "\"} " << cumulative << "\n";
+  }
+  cumulative += block.frameTimeHistogram[kFrameTimeBuckets - 1];
+  cout << "asteroids_frame_time_microseconds_bucket{le=\"+Inf\"} " << cumulative << "\n";
+  cout << "asteroids_frame_time_microseconds_sum " << block.frameTimeSumMicros << "\n";
+  cout << "asteroids_frame_time_microseconds_count " << block.frames << endl;
+}
+
+/**
+ * Finds the segment of the only game running. POSIX shared memory lives in
+ * /dev/shm on Linux, without the leading slash.
+ *
+ * @returns the name of the segment.
+ */
+static string findSegment() {
+  string prefix = string(kMetricsSegment + 1) + ".";
+  vector<string> found;
+  if (DIR* dir = opendir("/dev/shm")) {
+    while (dirent* entry = readdir(dir)) {
+      if (strncmp(entry->d_name, prefix.c_str(), prefix.size()) == 0) {
+        found.push_back(string("/") + entry->d_name);
+      }
+    }
+    closedir(dir);
+  }
+
+  //With several games running the reader cannot guess which one is wanted
+  if (found.size() != 1) {
+    string message = found.empty() ? "No asteroids game is publishing statistics" : "Several asteroids games are publishing statistics, pass a process id:";
+    for (const string& name : found) {
+      message += " " + name;
+    }
+    throw domain_error(message);
+  }
+  return found[0];
+}
+
+/**
+ * Reads the live statistics of a running asteroids game and prints them.
+ * Usage: metrics_reader [--prometheus] [process id or segment name]
+ * Without either the reader finds the only game running.
+ *
+ * @return The status code. Normal is 0 and 1 is bad.
+ */
+int main(int argc, char* argv[]) {
+  try {
+    bool prometheus = false;
+    string name;
+
+    //Reads the output format and the game to read from the arguments
+    for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "--prometheus") == 0) {
+        prometheus = true;
+      }
+      else if (isdigit((unsigned char) argv[i][0])) {
+        name = Metrics::segmentName(stol(argv[i]));
+      }
+      else {
+        name = argv[i];
+      }
+    }
+    if (name.empty()) {
+      name = findSegment();
+    }
+
+    MetricsBlock block = Metrics::read(name.c_str());
+    if (prometheus) {
+      printPrometheus(block);
+    }
+    else {
+      printPlain(block);
+    }
+  }
+  catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,155 @@
+#include <math.h>
+#include <algorithm>
+#include <cstring>
+
+#include "Mixer.h"
+
+using namespace std;
+using namespace asteroids;
+
+Mixer::Mixer() noexcept {
+  //Every voice starts free
+  for (auto& voice : voices_) {
+    voice = {nullptr, 0, 0, 0};
+  }
+}
+
+Mixer::~Mixer() {
+  //Stops the audio thread before the voices it reads are destroyed
+  close();
+}
+
+bool Mixer::open() noexcept {
+  //Asks for mono 16 bit audio with short buffers to keep latency low, taking
+  //whatever rate the device prefers since the samples are made to match it
+  SDL_AudioSpec desired;
+  SDL_AudioSpec obtained;
+  memset(&desired, 0, sizeof(desired));
+  desired.freq = 44100;
+  desired.format = AUDIO_S16SYS;
+  desired.channels = 1;
+  desired.samples = 512;
+  desired.callback = callback;
+  desired.userdata = this;
+
+  SDL_AudioDeviceID device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+  if (device == 0) {
+    return false;
+  }
+
+  //Prepares the sounds before the callback can ask for them, then starts
+  //playing and lets the game ask for sounds
+  frequency_ = obtained.freq;
+  prepareSamples();
+  SDL_PauseAudioDevice(device, 0);
+  device_.store(device, memory_order_release);
+  return true;
+}
+
+void Mixer::close() noexcept {
+  //Closing the device waits for the callback to finish, and the device is
+  //reset to ensure idempotence
+  SDL_AudioDeviceID device = device_.exchange(0);
+  if (device != 0) {
+    SDL_CloseAudioDevice(device);
+  }
+}
+
+void Mixer::play(Sound sound, uint8_t volume) noexcept {
+  //Nothing can hear the sound without a device
+  if (device_.load(memory_order_acquire) == 0) {
+    return;
+  }
+
+  //A full queue means the audio thread is stalled, so the sound is dropped
+  commands_.push({sound, volume});
+}
+
+void Mixer::mix(int16_t* out, int samples) noexcept {
+  //Starts every sound that was asked for since the last callback
+  Command command;
+  while (commands_.pop(command)) {
+    start(command);
+  }
+
+  //Adds up every playing voice, clipping the sum to the range of a sample
+  for (int i = 0; i < samples; i++) {
+    int sum = 0;
+    for (auto& voice : voices_) {
+      if (voice.samples) {
+        sum += voice.samples[voice.position] * voice.volume >> 8;
+        if (++voice.position == voice.length) {
+          voice.samples = nullptr;
+        }
+      }
+    }
+    out[i] = min(max(sum, -32768), 32767);
+  }
+}
+
+int Mixer::getFrequency() const noexcept {
+  //Returns the sample rate of the device
+  return frequency_;
+}
+
+void Mixer::prepareSamples() noexcept {
+  //The noise in the explosion and the engine comes from a small linear
+  //congruential generator so every run sounds the same
+  uint32_t noise = 22222;
+  auto nextNoise = [&noise]() {
+    noise = noise * 1664525 + 1013904223;
+    return (int) (noise >> 16) - 32768;
+  };
+
+  //The shot is a square wave sweeping down from 1200Hz over a tenth of a second
+  vector<int16_t>& fire = samples_[SoundFire];
+  fire.resize(frequency_ / 10);
+  double phase = 0;
+  for (unsigned i = 0; i < fire.size(); i++) {
+    double t = (double) i / fire.size();
+    phase += (1200 - 900 * t) / frequency_;
+    fire[i] = (phase - floor(phase) < 0.5 ? 9000 : -9000) * (1 - t);
+  }
+
+  //The explosion is half a second of low pass filtered noise fading out
+  vector<int16_t>& explosion = samples_[SoundExplosion];
+  explosion.resize(frequency_ / 2);
+  double filtered = 0;
+  for (unsigned i = 0; i < explosion.size(); i++) {
+    double t = (double) i / explosion.size();
+    filtered += (nextNoise() - filtered) * 0.15;
+    explosion[i] = filtered * exp(-5 * t);
+  }
+
+  //The engine is a short rumble of heavily filtered noise
+  vector<int16_t>& thrust = samples_[SoundThrust];
+  thrust.resize(frequency_ * 3 / 20);
+  filtered = 0;
+  for (unsigned i = 0; i < thrust.size(); i++) {
+    double t = (double) i / thrust.size();
+    filtered += (nextNoise() - filtered) * 0.05;
+    thrust[i] = filtered * 0.6 * sin(M_PI * t);
+  }
+}
+
+void Mixer::start(const Command& command) noexcept {
+  //Prefers a free voice, otherwise takes over the one with the least left to play
+  Voice* chosen = &voices_[0];
+  for (auto& voice : voices_) {
+    if (!voice.samples) {
+      chosen = &voice;
+      break;
+    }
+    if (voice.length - voice.position < chosen->length - chosen->position) {
+      chosen = &voice;
+    }
+  }
+
+  const vector<int16_t>& samples = samples_[command.sound];
+  *chosen = {samples.data(), (int) samples.size(), 0, command.volume};
+}
+
+void Mixer::callback(void* userdata, Uint8* stream, int length) {
+  //The device was opened for 16 bit mono so the stream is a run of samples
+  static_cast<Mixer*>(userdata)->mix(reinterpret_cast<int16_t*>(stream), length / (int) sizeof(int16_t));
+}
@@ -0,0 +1,143 @@
+#ifndef ASTEROIDS_MIXER_H
+#define ASTEROIDS_MIXER_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "SpscQueue.h"
+
+namespace asteroids {
+
+/** The sound effects the game can play */
+enum Sound : std::uint8_t {
+  /** A bullet being fired */
+  SoundFire,
+
+  /** An asteroid or the ship being destroyed */
+  SoundExplosion,
+
+  /** The ship's engine */
+  SoundThrust,
+
+  /** The number of sound effects */
+  kSoundCount
+};
+
+/**
+ * Mixes the game's sound effects inside the SDL audio callback. Every effect
+ * is synthesized once when the device opens, already in the format and rate
+ * the device plays, and the mixer plays them on a fixed pool of voices. The
+ * game asks for sounds through a wait-free queue so triggering one never
+ * allocates, locks or waits on the audio thread.
+ *
+ * @author Jai Aslam
+ */
+class Mixer {
+public:
+  /**
+  * Constructs a mixer which stays silent until open is called.
+  */
+  Mixer() noexcept;
+
+  /**
+  * Closes the audio device.
+  */
+  ~Mixer();
+
+  Mixer(const Mixer&) = delete;
+  Mixer& operator=(const Mixer&) = delete;
+
+  /**
+  * Opens the default audio device and prepares the sound effects for it. The
+  * audio subsystem must already be initialized. Any SDL audio driver works,
+  * including the dummy and disk drivers for running without speakers.
+  *
+  * @returns whether the device was opened, the game plays silently if not.
+  */
+  bool open() noexcept;
+
+  /**
+  * Stops and closes the audio device. Safe to call more than once.
+  */
+  void close() noexcept;
+
+  /**
+  * Asks for a sound to be played. Only one thread may ask for sounds. If the
+  * audio thread has fallen far behind the request is dropped.
+  */
+  void play(/** The sound to play */Sound sound, /** How loud, from 0 to 255 */std::uint8_t volume = 255) noexcept;
+
+  /**
+  * Mixes the next samples of audio. Called on the audio thread.
+  */
+  void mix(/** Receives the mixed samples */std::int16_t* out, /** The number of samples to mix */int samples) noexcept;
+
+  /**
+  * @returns the sample rate the sound effects were prepared for.
+  */
+  int getFrequency() const noexcept;
+
+private:
+  /** The number of sounds that can play at the same time */
+  static constexpr int kVoices = 16;
+
+  /** A request from the game to start a sound */
+  struct Command {
+    /** The sound to start */
+    Sound sound;
+
+    /** How loud to play it */
+    std::uint8_t volume;
+  };
+
+  /** A sound being played */
+  struct Voice {
+    /** The samples of the sound, nullptr if the voice is free */
+    const std::int16_t* samples;
+
+    /** The number of samples in the sound */
+    int length;
+
+    /** The next sample to play */
+    int position;
+
+    /** How loud to play it, from 0 to 255 */
+    int volume;
+  };
+
+  /** The requests waiting for the audio thread */
+  SpscQueue<Command, 64> commands_;
+
+  /** The pool of voices, only touched by the audio thread */
+  Voice voices_[kVoices];
+
+  /** The prepared samples of each sound effect */
+  std::vector<std::int16_t> samples_[kSoundCount];
+
+  /** The open audio device, 0 if none is open, read by the thread asking for sounds */
+  std::atomic<SDL_AudioDeviceID> device_{0};
+
+  /** The sample rate of the device */
+  int frequency_ = 44100;
+
+  /**
+  * Synthesizes every sound effect at the device's sample rate.
+  */
+  void prepareSamples() noexcept;
+
+  /**
+  * Starts the given request on a free voice, or on the voice closest to
+  * finishing if every voice is busy.
+  */
+  void start(/** The request to start */const Command& command) noexcept;
+
+  /**
+  * The SDL audio callback, forwards to mix.
+  */
+  static void callback(/** The mixer */void* userdata, /** Receives the audio */Uint8* stream, /** The size of the stream in bytes */int length);
+};
+}
+
+#endif
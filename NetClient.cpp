@@ -0,0 +1,116 @@
+#include <algorithm>
+
+#include "NetClient.h"
+#include "AllocationTracker.h"
+
+using namespace std;
+using namespace asteroids;
+
+NetClient::NetClient(const char* host, int port)
+  : socket_(0, !UdpSocket::isLoopback(UdpSocket::address(host, port))), server_(UdpSocket::address(host, port)), received_(kHistory) {
+
+  //Has the operating system drop datagrams from anyone but the server
+  socket_.connect(server_);
+}
+
+NetClient::~NetClient() {
+  //Lets the server free the client's place rather than waiting for it to time out
+  BitWriter out(packet_, kMaxPacketBytes);
+  out.write(kNetMagic, 16);
+  out.write(PacketBye, 8);
+  socket_.send(server_, packet_, out.size());
+}
+
+void NetClient::send(unsigned action) noexcept {
+  BitWriter out(packet_, kMaxPacketBytes);
+  out.write(kNetMagic, 16);
+  out.write(PacketInput, 8);
+  out.write(latest_, 32);
+  out.write(action, 5);
+  socket_.send(server_, packet_, out.size());
+}
+
+bool NetClient::receive() noexcept {
+  AllocationScope scope(AllocationTracker::PhaseNetwork);
+  bool newer = false;
+  sockaddr_in from;
+  int size;
+  while ((size = socket_.receive(packet_, kMaxPacketBytes, from)) >= 0) {
+    //Ignores anything not from the server, in case the socket was reached
+    //before it was connected, then anything that is not a snapshot or is
+    //older than one already drawn
+    if (!UdpSocket::sameAddress(from, server_)) {
+      continue;
+    }
+    BitReader in(packet_, size);
+    if (in.read(16) != kNetMagic || in.read(8) != PacketSnapshot) {
+      continue;
+    }
+    uint32_t tick = in.read(32);
+    uint32_t baselineTick = in.read(32);
+    if (tick <= latest_) {
+      continue;
+    }
+
+    //The state can only be decoded if the one it was sent against is still here
+    const NetState* baseline = &empty_;
+    if (baselineTick != 0) {
+      if (tick - baselineTick >= kHistory) {
+        continue;
+      }
+      baseline = &received_[baselineTick % kHistory];
+      if (baseline->tick != baselineTick) {
+        continue;
+      }
+    }
+    if (!decoding_.decode(in, *baseline)) {
+      continue;
+    }
+    decoding_.tick = tick;
+    swap(decoding_, received_[tick % kHistory]);
+    bytesReceived_ += size;
+    statesReceived_++;
+
+    previous_ = latest_;
+    previousArrival_ = latestArrival_;
+    latest_ = tick;
+    latestArrival_ = chrono::steady_clock::now();
+    newer = true;
+  }
+  return newer;
+}
+
+bool NetClient::interpolate(FrameSnapshot& snapshot) const noexcept {
+  if (latest_ == 0) {
+    return false;
+  }
+
+  //Without an older state, or one that was overwritten, the newest is drawn as it is
+  const NetState& latest = received_[latest_ % kHistory];
+  if (previous_ == 0 || received_[previous_ % kHistory].tick != previous_) {
+    latest.interpolate(latest, 1, snapshot);
+    return true;
+  }
+
+  //Slides from the older state to the newest over the time it took the newest to arrive
+  auto interval = latestArrival_ - previousArrival_;
+  auto elapsed = chrono::steady_clock::now() - latestArrival_;
+  double alpha = interval.count() > 0 ? (double) elapsed.count() / interval.count() : 1;
+  received_[previous_ % kHistory].interpolate(latest, clamp(alpha, 0.0, 1.0), snapshot);
+  return true;
+}
+
+int NetClient::port() const noexcept {
+  //Returns the port the socket is bound to
+  return socket_.port();
+}
+
+uint64_t NetClient::bytesReceived() const noexcept {
+  //Returns the bytes received
+  return bytesReceived_;
+}
+
+uint64_t NetClient::statesReceived() const noexcept {
+  //Returns the states received
+  return statesReceived_;
+}
@@ -0,0 +1,116 @@
+#ifndef ASTEROIDS_NETCLIENT_H
+#define ASTEROIDS_NETCLIENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <netinet/in.h>
+
+#include "NetState.h"
+#include "UdpSocket.h"
+
+namespace asteroids {
+
+/**
+ * Plays or watches a game served by a NetServer. The client sends the
+ * player's actions to the server and draws the states the server sends
+ * back, sliding everything smoothly from the second newest state to the
+ * newest over the time between their arrival. That way what is drawn is
+ * always one packet behind the server but never jumps or stalls between
+ * packets.
+ *
+ * @author Jai Aslam
+ */
+class NetClient {
+public:
+  /**
+  * Prepares to talk to the server at the given address and only to it. The
+  * socket only listens on loopback when the server is on this machine.
+  * Throws a domain_error if the address is not valid or no socket can be opened.
+  */
+  NetClient(/** The server's IPv4 address, e.g. 127.0.0.1 */const char* host, /** The server's port */int port);
+
+  /**
+  * Tells the server the client is leaving.
+  */
+  ~NetClient();
+
+  /**
+  * Sends the player's actions since the last send to the server, along with
+  * the latest state received so the server knows what to send against.
+  */
+  void send(/** A combination of Action flags */unsigned action) noexcept;
+
+  /**
+  * Receives every waiting state from the server.
+  *
+  * @returns whether a newer state arrived.
+  */
+  bool receive() noexcept;
+
+  /**
+  * Fills a snapshot for drawing with the state between the two newest
+  * states that matches the current time.
+  *
+  * @returns whether any state has arrived yet.
+  */
+  bool interpolate(/** The snapshot to fill */FrameSnapshot& snapshot) const noexcept;
+
+  /**
+  * @returns the port the client receives states on.
+  */
+  int port() const noexcept;
+
+  /**
+  * @returns the number of bytes of states received.
+  */
+  std::uint64_t bytesReceived() const noexcept;
+
+  /**
+  * @returns the number of states received and decoded.
+  */
+  std::uint64_t statesReceived() const noexcept;
+
+private:
+  /** The number of states remembered for the server to send differences against */
+  static constexpr int kHistory = 32;
+
+  /** The socket the server is talked to through */
+  UdpSocket socket_;
+
+  /** The server's address */
+  const sockaddr_in server_;
+
+  /** The states received, indexed by tick modulo kHistory */
+  std::vector<NetState> received_;
+
+  /** The state being decoded */
+  NetState decoding_;
+
+  /** The state everything starts from */
+  const NetState empty_;
+
+  /** The newest state received, 0 if none */
+  std::uint32_t latest_ = 0;
+
+  /** The state received before the newest, 0 if none */
+  std::uint32_t previous_ = 0;
+
+  /** When the newest state arrived */
+  std::chrono::steady_clock::time_point latestArrival_;
+
+  /** When the state before the newest arrived */
+  std::chrono::steady_clock::time_point previousArrival_;
+
+  /** The number of bytes of states received */
+  std::uint64_t bytesReceived_ = 0;
+
+  /** The number of states received and decoded */
+  std::uint64_t statesReceived_ = 0;
+
+  /** Holds each packet being sent or received */
+  std::uint8_t packet_[kMaxPacketBytes];
+};
+}
+
+#endif
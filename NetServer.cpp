@@ -0,0 +1,151 @@
+#include <chrono>
+#include <algorithm>
+
+#include "NetServer.h"
+#include "Game.h"
+#include "AllocationTracker.h"
+
+using namespace std;
+using namespace asteroids;
+
+NetServer::NetServer(int port, bool anyInterface) : socket_(port, anyInterface) {
+  //Client records are reused so connecting never moves the others
+  clients_.reserve(kMaxClients);
+}
+
+NetServer::~NetServer() {}
+
+void NetServer::receive(Game& game) noexcept {
+  AllocationScope scope(AllocationTracker::PhaseNetwork);
+  auto start = chrono::steady_clock::now();
+
+  sockaddr_in from;
+  int size;
+  while ((size = socket_.receive(packet_, kMaxPacketBytes, from)) >= 0) {
+    //Ignores anything that is not an asteroids input packet
+    BitReader in(packet_, size);
+    if (in.read(16) != kNetMagic) {
+      continue;
+    }
+    unsigned type = in.read(8);
+    uint32_t ack = 0;
+    unsigned action = 0;
+    if (type == PacketInput) {
+      ack = in.read(32);
+      action = in.read(5);
+    }
+    if (in.overflowed() || (type != PacketInput && type != PacketBye)) {
+      continue;
+    }
+
+    //Only a well formed input packet connects a new client, anything else
+    //has to come from a client already connected
+    Client* client = find(from);
+    if (!client && type == PacketInput) {
+      client = connect(from);
+    }
+    if (!client) {
+      continue;
+    }
+    stats_.packetsReceived++;
+    stats_.bytesReceived += size;
+    client->lastHeard = stats_.ticks;
+
+    //A client leaving gives up its record straight away
+    if (type == PacketBye) {
+      if (client != &clients_.back()) {
+        *client = move(clients_.back());
+      }
+      clients_.pop_back();
+      continue;
+    }
+
+    //Packets can arrive out of order so only a newer acknowledgement counts,
+    //and one for a tick that has not been sent yet is ignored
+    if (ack <= stats_.ticks) {
+      client->ack = max(client->ack, ack);
+    }
+    game.applyAction(action);
+  }
+
+  receiveMicros_ = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+void NetServer::broadcast(const Game& game) noexcept {
+  AllocationScope scope(AllocationTracker::PhaseNetwork);
+  auto start = chrono::steady_clock::now();
+
+  //Ticks start at 1 so 0 can mean no state
+  stats_.ticks++;
+  uint32_t tick = stats_.ticks;
+  current_.capture(game, tick);
+
+  //Drops the clients which went quiet
+  for (unsigned i = 0; i < clients_.size();) {
+    if (stats_.ticks - clients_[i].lastHeard > kTimeoutTicks) {
+      if (i != clients_.size() - 1) {
+        clients_[i] = move(clients_.back());
+      }
+      clients_.pop_back();
+    }
+    else {
+      i++;
+    }
+  }
+
+  for (Client& client : clients_) {
+    //Sends the difference from the last state the client received if it is
+    //still remembered, otherwise everything
+    const NetState* baseline = &empty_;
+    if (client.ack != 0 && tick - client.ack < kHistory && client.sent[client.ack % kHistory].tick == client.ack) {
+      baseline = &client.sent[client.ack % kHistory];
+    }
+
+    BitWriter out(packet_, kMaxPacketBytes);
+    out.write(kNetMagic, 16);
+    out.write(PacketSnapshot, 8);
+    out.write(tick, 32);
+    out.write(baseline->tick, 32);
+    current_.encode(*baseline, out, kMaxPacketBytes * 8, client.sent[tick % kHistory]);
+
+    if (socket_.send(client.address, packet_, out.size())) {
+      stats_.packetsSent++;
+      stats_.bytesSent += out.size();
+    }
+  }
+  stats_.clients = clients_.size();
+
+  //Counts the time spent on the clients this tick
+  auto micros = receiveMicros_ + chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+  stats_.lastTickMicros = micros;
+  stats_.maxTickMicros = max(stats_.maxTickMicros, stats_.lastTickMicros);
+  receiveMicros_ = 0;
+}
+
+const NetServerStats& NetServer::stats() const noexcept {
+  //Returns the statistics
+  return stats_;
+}
+
+int NetServer::port() const noexcept {
+  //Returns the port being listened on
+  return socket_.port();
+}
+
+NetServer::Client* NetServer::find(const sockaddr_in& address) noexcept {
+  for (Client& client : clients_) {
+    if (UdpSocket::sameAddress(client.address, address)) {
+      return &client;
+    }
+  }
+  return nullptr;
+}
+
+NetServer::Client* NetServer::connect(const sockaddr_in& address) noexcept {
+  //Connects a new client if there is room for it
+  if (clients_.size() == kMaxClients) {
+    return nullptr;
+  }
+  clients_.push_back(Client{address, 0, stats_.ticks, vector<NetState>(kHistory)});
+  return &clients_.back();
+}
@@ -0,0 +1,151 @@
+#ifndef ASTEROIDS_NETSERVER_H
+#define ASTEROIDS_NETSERVER_H
+
+#include <cstdint>
+#include <vector>
+#include <netinet/in.h>
+
+#include "NetState.h"
+#include "UdpSocket.h"
+
+namespace asteroids {
+
+/**
+ * What the server has sent and received, for checking that the bandwidth to
+ * each client and the time spent on networking stay bounded.
+ */
+struct NetServerStats {
+  /** The number of ticks broadcast */
+  std::uint64_t ticks = 0;
+
+  /** The number of clients currently connected */
+  std::uint32_t clients = 0;
+
+  /** The number of snapshot packets sent */
+  std::uint64_t packetsSent = 0;
+
+  /** The number of bytes of snapshots sent */
+  std::uint64_t bytesSent = 0;
+
+  /** The number of input packets received */
+  std::uint64_t packetsReceived = 0;
+
+  /** The number of bytes of input received */
+  std::uint64_t bytesReceived = 0;
+
+  /** The time the last tick spent receiving and broadcasting in microseconds */
+  std::uint64_t lastTickMicros = 0;
+
+  /** The longest time a tick spent receiving and broadcasting in microseconds */
+  std::uint64_t maxTickMicros = 0;
+};
+
+/**
+ * Serves a game to clients over UDP. The game runs only on the server; the
+ * clients send the actions of their players and the server sends every
+ * client the state of the game after each tick.
+ *
+ * Each state is sent as the difference from the last state the client said
+ * it received, and is cut short at kMaxPacketBytes, so the bandwidth to a
+ * client stays bounded however many asteroids there are. The number of
+ * clients is capped too, which bounds the time a tick spends on them.
+ *
+ * @author Jai Aslam
+ */
+class NetServer {
+public:
+  /** The most clients connected at once */
+  static constexpr int kMaxClients = 32;
+
+  /**
+  * Starts listening on the given port. Throws a domain_error if the port
+  * cannot be bound.
+  */
+  NetServer(/** The port to listen on, 0 picks any free port */int port, /** Whether to listen on every interface rather than just loopback */bool anyInterface = false);
+
+  /**
+  * Stops listening.
+  */
+  ~NetServer();
+
+  /**
+  * Receives every waiting packet, connecting new clients and applying the
+  * actions of every client to the game.
+  */
+  void receive(/** The game being served */Game& game) noexcept;
+
+  /**
+  * Sends the state of the game to every client, dropping clients which have
+  * not been heard from in a while.
+  */
+  void broadcast(/** The game being served */const Game& game) noexcept;
+
+  /**
+  * @returns what the server has sent and received so far.
+  */
+  const NetServerStats& stats() const noexcept;
+
+  /**
+  * @returns the port the server is listening on.
+  */
+  int port() const noexcept;
+
+private:
+  /** The number of states remembered per client to send differences against */
+  static constexpr int kHistory = 32;
+
+  /** The ticks a client may stay silent before it is dropped */
+  static constexpr std::uint64_t kTimeoutTicks = 300;
+
+  /** A connected client */
+  struct Client {
+    /** Where the client's packets come from */
+    sockaddr_in address;
+
+    /** The latest tick the client said it received, 0 if none */
+    std::uint32_t ack = 0;
+
+    /** The tick the client was last heard from */
+    std::uint64_t lastHeard = 0;
+
+    /** The states last sent to the client, indexed by tick modulo kHistory */
+    std::vector<NetState> sent;
+  };
+
+  /** The socket clients talk to */
+  UdpSocket socket_;
+
+  /** The connected clients */
+  std::vector<Client> clients_;
+
+  /** The state of the game being broadcast */
+  NetState current_;
+
+  /** The state a new client starts from */
+  const NetState empty_;
+
+  /** What has been sent and received so far */
+  NetServerStats stats_;
+
+  /** The time spent receiving during the current tick in microseconds */
+  std::uint64_t receiveMicros_ = 0;
+
+  /** Holds each packet being sent or received */
+  std::uint8_t packet_[kMaxPacketBytes];
+
+  /**
+  * @returns the connected client with the given address, or nullptr if
+  * there is none.
+  */
+  Client* find(/** The client's address */const sockaddr_in& address) noexcept;
+
+  /**
+  * Connects a new client at the given address.
+  *
+  * @returns the new client, or nullptr if the server is full.
+  */
+  Client* connect(/** The client's address */const sockaddr_in& address) noexcept;
+};
+}
+
+#endif
@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "NetState.h"
+#include "Game.h"
+
+using namespace std;
+using namespace asteroids;
+
+/** Coordinates are sent offset by this much so entities just off the screen fit */
+static constexpr int kCoordinateOffset = 256;
+
+/** The bits in a full x coordinate, enough for -256 to 1791 */
+static constexpr int kXBits = 11;
+
+/** The bits in a full y coordinate, enough for -256 to 767 */
+static constexpr int kYBits = 10;
+
+/** The bits in each part of a small move, enough for -16 to 15 */
+static constexpr int kMoveBits = 5;
+
+/** The most bits a single asteroid takes */
+static constexpr int kRockBits = 1 + 1 + 6 + 3 + 1 + kXBits + kYBits;
+
+/** The most bits a single bullet takes */
+static constexpr int kShotBits = 1 + 1 + 4 + 1 + kXBits + kYBits;
+
+/** Moves further than this between the two states are wraps and are not interpolated */
+static constexpr int kMaxSlide = 32;
+
+/**
+ * Writes a value which is expected to lie between min and min + 2^bits - 1,
+ * clamping it if it does not.
+ */
+static void writeRange(/** Receives the bits */BitWriter& out, /** The value to write */int value, /** The smallest value */int min, /** The number of bits */int bits) {
+  out.write(clamp(value - min, 0, (1 << bits) - 1), bits);
+}
+
+/**
+ * Reads a value written by writeRange.
+ */
+static int readRange(/** The bits to read */BitReader& in, /** The smallest value */int min, /** The number of bits */int bits) {
+  return (int) in.read(bits) + min;
+}
+
+/**
+ * Writes a position as a small move from the baseline position if it is
+ * close enough, otherwise in full.
+ */
+static void writePosition(/** Receives the bits */BitWriter& out, /** The x coordinate */int x, /** The y coordinate */int y, /** The baseline x coordinate */int baseX, /** The baseline y coordinate */int baseY, /** Whether there is a baseline position */bool hasBase) {
+  int limit = 1 << (kMoveBits - 1);
+  bool small = hasBase && x - baseX >= -limit && x - baseX < limit && y - baseY >= -limit && y - baseY < limit;
+  out.write(small, 1);
+  if (small) {
+    writeRange(out, x - baseX, -limit, kMoveBits);
+    writeRange(out, y - baseY, -limit, kMoveBits);
+  }
+  else {
+    writeRange(out, x, -kCoordinateOffset, kXBits);
+    writeRange(out, y, -kCoordinateOffset, kYBits);
+  }
+}
+
+/**
+ * Reads a position written by writePosition.
+ */
+static void readPosition(/** The bits to read */BitReader& in, /** Receives the x coordinate */int& x, /** Receives the y coordinate */int& y, /** The baseline x coordinate */int baseX, /** The baseline y coordinate */int baseY) {
+  int limit = 1 << (kMoveBits - 1);
+  if (in.read(1)) {
+    x = baseX + readRange(in, -limit, kMoveBits);
+    y = baseY + readRange(in, -limit, kMoveBits);
+  }
+  else {
+    x = readRange(in, -kCoordinateOffset, kXBits);
+    y = readRange(in, -kCoordinateOffset, kYBits);
+  }
+}
+
+/**
+ * @returns the value the given fraction of the way from a to b, or b if they
+ * are too far apart to be the same entity sliding.
+ */
+static int slide(/** The value being moved from */int a, /** The value being moved towards */int b, /** How far towards b, from 0 to 1 */double alpha) {
+  if (abs(b - a) > kMaxSlide) {
+    return b;
+  }
+  return a + (int) ((b - a) * alpha);
+}
+
+void NetState::capture(const Game& game, uint32_t captureTick) noexcept {
+  tick = captureTick;
+  const Ship& player = game.getPlayer();
+  shipX = player.getX();
+  shipY = player.getY();
+  shipAngle = player.getAngle();
+
+  //Keeps only what the clients draw of each asteroid and bullet
+  asteroids.clear();
+  for (const Asteroid& ast : game.getAsteroids()) {
+    asteroids.push_back({ast.getX(), ast.getY(), ast.getRadius(), ast.getDirection()});
+  }
+  bullets.clear();
+  for (const Bullet& bullet : game.getBullets()) {
+    bullets.push_back({bullet.getX(), bullet.getY(), bullet.getDirection()});
+  }
+
+  score = game.getScore();
+  lives = game.getLives();
+  level = game.getLevel();
+}
+
+void NetState::encode(const NetState& baseline, BitWriter& out, int budgetBits, NetState& sent) const noexcept {
+  sent.tick = tick;
+
+  //The ship moves every time the player touches a key, so it is always sent
+  writePosition(out, shipX, shipY, baseline.shipX, baseline.shipY, true);
+  out.write(shipAngle != baseline.shipAngle, 1);
+  if (shipAngle != baseline.shipAngle) {
+    writeRange(out, shipAngle, -5, 4);
+  }
+  sent.shipX = shipX;
+  sent.shipY = shipY;
+  sent.shipAngle = shipAngle;
+
+  //The score, lives and level rarely change so each costs a bit when they do not
+  out.write(score != baseline.score, 1);
+  if (score != baseline.score) {
+    out.write(score, 32);
+  }
+  out.write(lives != baseline.lives, 1);
+  if (lives != baseline.lives) {
+    writeRange(out, lives, 0, 8);
+  }
+  out.write(level != baseline.level, 1);
+  if (level != baseline.level) {
+    writeRange(out, level, 0, 16);
+  }
+  sent.score = score;
+  sent.lives = lives;
+  sent.level = level;
+
+  //Sends as many asteroids as fit, leaving room for the bullet count, and
+  //fills in how many that was once it is known
+  int countAt = out.position();
+  out.write(0, 16);
+  sent.asteroids.clear();
+  for (unsigned i = 0; i < asteroids.size() && i < 0xFFFF; i++) {
+    if (out.position() + kRockBits + 16 > budgetBits) {
+      break;
+    }
+    const Rock& rock = asteroids[i];
+    bool hasBase = i < baseline.asteroids.size();
+    const Rock* base = hasBase ? &baseline.asteroids[i] : nullptr;
+
+    //An asteroid which has not changed at all costs one bit
+    bool changed = !hasBase || rock.x != base->x || rock.y != base->y || rock.radius != base->radius || rock.direction != base->direction;
+    out.write(changed, 1);
+    if (changed) {
+      //Asteroids keep their size and direction until they split
+      bool sameShape = hasBase && rock.radius == base->radius && rock.direction == base->direction;
+      out.write(sameShape, 1);
+      if (!sameShape) {
+        writeRange(out, rock.radius, 0, 6);
+        writeRange(out, rock.direction, 0, 3);
+      }
+      writePosition(out, rock.x, rock.y, hasBase ? base->x : 0, hasBase ? base->y : 0, hasBase);
+    }
+    sent.asteroids.push_back(rock);
+  }
+  out.patch(countAt, sent.asteroids.size(), 16);
+
+  //Then as many bullets as fit in what is left
+  countAt = out.position();
+  out.write(0, 16);
+  sent.bullets.clear();
+  for (unsigned i = 0; i < bullets.size() && i < 0xFFFF; i++) {
+    if (out.position() + kShotBits > budgetBits) {
+      break;
+    }
+    const Shot& shot = bullets[i];
+    bool hasBase = i < baseline.bullets.size();
+    const Shot* base = hasBase ? &baseline.bullets[i] : nullptr;
+
+    bool changed = !hasBase || shot.x != base->x || shot.y != base->y || shot.direction != base->direction;
+    out.write(changed, 1);
+    if (changed) {
+      bool sameShape = hasBase && shot.direction == base->direction;
+      out.write(sameShape, 1);
+      if (!sameShape) {
+        writeRange(out, shot.direction, -5, 4);
+      }
+      writePosition(out, shot.x, shot.y, hasBase ? base->x : 0, hasBase ? base->y : 0, hasBase);
+    }
+    sent.bullets.push_back(shot);
+  }
+  out.patch(countAt, sent.bullets.size(), 16);
+}
+
+bool NetState::decode(BitReader& in, const NetState& baseline) noexcept {
+  //Reads everything in the same order encode wrote it
+  readPosition(in, shipX, shipY, baseline.shipX, baseline.shipY);
+  shipAngle = in.read(1) ? readRange(in, -5, 4) : baseline.shipAngle;
+  score = in.read(1) ? (int) in.read(32) : baseline.score;
+  lives = in.read(1) ? readRange(in, 0, 8) : baseline.lives;
+  level = in.read(1) ? readRange(in, 0, 16) : baseline.level;
+
+  unsigned count = in.read(16);
+  asteroids.clear();
+  for (unsigned i = 0; i < count && !in.overflowed(); i++) {
+    bool hasBase = i < baseline.asteroids.size();
+    Rock rock = hasBase ? baseline.asteroids[i] : Rock{0, 0, 0, 0};
+    if (in.read(1)) {
+      if (!in.read(1)) {
+        rock.radius = readRange(in, 0, 6);
+        rock.direction = readRange(in, 0, 3);
+      }
+      readPosition(in, rock.x, rock.y, rock.x, rock.y);
+    }
+    asteroids.push_back(rock);
+  }
+
+  count = in.read(16);
+  bullets.clear();
+  for (unsigned i = 0; i < count && !in.overflowed(); i++) {
+    bool hasBase = i < baseline.bullets.size();
+    Shot shot = hasBase ? baseline.bullets[i] : Shot{0, 0, 0};
+    if (in.read(1)) {
+      if (!in.read(1)) {
+        shot.direction = readRange(in, -5, 4);
+      }
+      readPosition(in, shot.x, shot.y, shot.x, shot.y);
+    }
+    bullets.push_back(shot);
+  }
+  return !in.overflowed();
+}
+
+void NetState::interpolate(const NetState& next, double alpha, FrameSnapshot& snapshot) const noexcept {
+  //The ship slides unless it wrapped around the screen
+  snapshot.player = Ship(slide(shipX, next.shipX, alpha), slide(shipY, next.shipY, alpha), 10);
+  snapshot.player.updateAngle(next.shipAngle);
+
+  //Asteroids and bullets slide if the one in the same place in the older
+  //state looks like the same entity
+  snapshot.asteroids.clear();
+  for (unsigned i = 0; i < next.asteroids.size(); i++) {
+    const Rock& to = next.asteroids[i];
+    int x = to.x;
+    int y = to.y;
+    if (i < asteroids.size() && asteroids[i].radius == to.radius && asteroids[i].direction == to.direction) {
+      x = slide(asteroids[i].x, to.x, alpha);
+      y = slide(asteroids[i].y, to.y, alpha);
+    }
+    snapshot.asteroids.push_back(Asteroid(x, y, to.radius, to.direction));
+  }
+  snapshot.bullets.clear();
+  for (unsigned i = 0; i < next.bullets.size(); i++) {
+    const Shot& to = next.bullets[i];
+    int x = to.x;
+    int y = to.y;
+    if (i < bullets.size() && bullets[i].direction == to.direction) {
+      x = slide(bullets[i].x, to.x, alpha);
+      y = slide(bullets[i].y, to.y, alpha);
+    }
+    snapshot.bullets.push_back(Bullet(x, y, to.direction));
+  }
+
+  snapshot.score = next.score;
+  snapshot.lives = next.lives;
+  snapshot.level = next.level;
+}
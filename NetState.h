@@ -0,0 +1,127 @@
+#ifndef ASTEROIDS_NETSTATE_H
+#define ASTEROIDS_NETSTATE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "BitStream.h"
+#include "FrameSnapshot.h"
+
+namespace asteroids {
+
+class Game;
+
+/** Identifies a datagram as an asteroids packet */
+constexpr std::uint16_t kNetMagic = 0xA57E;
+
+/** The largest packet either side sends, small enough to never be fragmented */
+constexpr int kMaxPacketBytes = 1200;
+
+/** The kinds of packet sent between the server and its clients */
+enum PacketType : std::uint8_t {
+  /** A client's actions for the next tick along with the last snapshot it received */
+  PacketInput,
+
+  /** The server's state of the game, relative to a snapshot the client already has */
+  PacketSnapshot,
+
+  /** A client leaving */
+  PacketBye
+};
+
+/**
+ * The state of the game sent from the server to its clients: the pose of the
+ * ship, the asteroids, the bullets, the score, lives and level. Only whole
+ * pixels are kept, which is all the game draws.
+ *
+ * A state is sent as the difference from an older state the client already
+ * has, matching asteroids and bullets by their position in the list. An
+ * unchanged entity costs a single bit and one that moved a little since the
+ * older state costs about a dozen.
+ *
+ * @author Jai Aslam
+ */
+struct NetState {
+  /** An asteroid as it is sent */
+  struct Rock {
+    /** The x coordinate of the center */
+    int x;
+
+    /** The y coordinate of the center */
+    int y;
+
+    /** The radius */
+    int radius;
+
+    /** The direction it travels in */
+    int direction;
+  };
+
+  /** A bullet as it is sent */
+  struct Shot {
+    /** The x coordinate */
+    int x;
+
+    /** The y coordinate */
+    int y;
+
+    /** The direction it travels in */
+    int direction;
+  };
+
+  /** The server tick the state was captured on, 0 for an empty state */
+  std::uint32_t tick = 0;
+
+  /** The x coordinate of the ship */
+  int shipX = 0;
+
+  /** The y coordinate of the ship */
+  int shipY = 0;
+
+  /** The angle of the ship */
+  int shipAngle = 0;
+
+  /** The asteroids on the screen */
+  std::vector<Rock> asteroids;
+
+  /** The bullets on the screen */
+  std::vector<Shot> bullets;
+
+  /** The current score */
+  int score = 0;
+
+  /** The number of lives left */
+  int lives = 0;
+
+  /** The current level */
+  int level = 0;
+
+  /**
+  * Copies the state of the given game, reusing the storage this state has.
+  */
+  void capture(/** The game to copy */const Game& game, /** The tick the game is on */std::uint32_t captureTick) noexcept;
+
+  /**
+  * Writes this state as the difference from the given baseline. Asteroids
+  * and bullets which do not fit in the given number of bits are left out,
+  * so sent receives exactly what the client will end up with.
+  */
+  void encode(/** The state the client already has, empty to send everything */const NetState& baseline, /** Receives the bits */BitWriter& out, /** The most bits to write */int budgetBits, /** Receives the state the client will decode */NetState& sent) const noexcept;
+
+  /**
+  * Reads a state written by encode against the same baseline.
+  *
+  * @returns whether the state was read without running out of bits.
+  */
+  bool decode(/** The bits to read */BitReader& in, /** The state the server encoded against */const NetState& baseline) noexcept;
+
+  /**
+  * Fills a snapshot for drawing with this state, moved the given fraction of
+  * the way towards the next state. Entities which changed shape or wrapped
+  * around the screen jump rather than sliding across it.
+  */
+  void interpolate(/** The state being moved towards */const NetState& next, /** How far towards the next state, from 0 to 1 */double alpha, /** The snapshot to fill */FrameSnapshot& snapshot) const noexcept;
+};
+}
+
+#endif
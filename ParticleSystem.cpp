@@ -0,0 +1,145 @@
+#include <math.h>
+#include <algorithm>
+
+#include "ParticleSystem.h"
+
+using namespace std;
+using namespace asteroids;
+
+ParticleSystem::ParticleSystem(int capacity)
+  : capacity_(capacity), x_(capacity), y_(capacity), vx_(capacity), vy_(capacity),
+    life_(capacity), decay_(capacity), colour_(capacity), batch_(capacity) {
+  //Spreads the directions evenly around the circle
+  for (int i = 0; i < kDirections; i++) {
+    cos_[i] = cos(2 * M_PI * i / kDirections);
+    sin_[i] = sin(2 * M_PI * i / kDirections);
+  }
+}
+
+ParticleSystem::~ParticleSystem() {}
+
+void ParticleSystem::emitExplosion(int x, int y, int radius) noexcept {
+  //Throws debris out evenly in every direction at a random speed
+  for (int i = 0; i < radius * 2; i++) {
+    uint32_t random = nextRandom();
+    int direction = random % kDirections;
+    float speed = 0.5f + (random >> 8) % 100 / 40.0f;
+    int lifetime = 30 + (random >> 16) % 30;
+    emit(x, y, cos_[direction] * speed, sin_[direction] * speed, lifetime, PaletteDebris);
+  }
+}
+
+void ParticleSystem::emitThrust(int x, int y, float angle) noexcept {
+  //The exhaust leaves the back of the ship, so opposite the direction it moves in
+  float backX = -cos(angle);
+  float backY = -sin(angle);
+
+  //Scatters the exhaust a little to either side of straight back
+  for (int i = 0; i < 8; i++) {
+    uint32_t random = nextRandom();
+    float spread = ((int) (random % 64) - 32) / 64.0f;
+    float speed = 1.5f + (random >> 8) % 64 / 32.0f;
+    int lifetime = 10 + (random >> 16) % 10;
+    emit(x, y, (backX - backY * spread) * speed, (backY + backX * spread) * speed, lifetime, PaletteExhaust);
+  }
+}
+
+void ParticleSystem::copyFrom(const ParticleSystem& other) noexcept {
+  //Only the live particles are worth copying
+  count_ = min(other.count_, capacity_);
+  copy_n(other.x_.begin(), count_, x_.begin());
+  copy_n(other.y_.begin(), count_, y_.begin());
+  copy_n(other.vx_.begin(), count_, vx_.begin());
+  copy_n(other.vy_.begin(), count_, vy_.begin());
+  copy_n(other.life_.begin(), count_, life_.begin());
+  copy_n(other.decay_.begin(), count_, decay_.begin());
+  copy_n(other.colour_.begin(), count_, colour_.begin());
+}
+
+void ParticleSystem::update() noexcept {
+  //Moves and fades every particle, packing the survivors to the front of the
+  //arrays as it goes so no second pass is needed to remove the dead ones
+  int live = 0;
+  for (int i = 0; i < count_; i++) {
+    float life = life_[i] - decay_[i];
+    if (life > 0) {
+      x_[live] = x_[i] + vx_[i];
+      y_[live] = y_[i] + vy_[i];
+      vx_[live] = vx_[i];
+      vy_[live] = vy_[i];
+      life_[live] = life;
+      decay_[live] = decay_[i];
+      colour_[live] = colour_[i];
+      live++;
+    }
+  }
+  count_ = live;
+}
+
+void ParticleSystem::draw(SDL_Renderer* r) noexcept {
+  //The full colour of each palette entry
+  static const Uint8 palette[kPaletteSize][3] = {{0, 255, 0}, {255, 140, 0}};
+
+  //Counts how many particles are drawn in each colour and brightness
+  int counts[kPaletteSize * kFadeLevels] = {0};
+  for (int i = 0; i < count_; i++) {
+    int fade = min((int) (life_[i] * kFadeLevels), kFadeLevels - 1);
+    counts[colour_[i] * kFadeLevels + fade]++;
+  }
+
+  //Works out where each group starts in the batch
+  int starts[kPaletteSize * kFadeLevels];
+  int offsets[kPaletteSize * kFadeLevels];
+  int start = 0;
+  for (int bucket = 0; bucket < kPaletteSize * kFadeLevels; bucket++) {
+    starts[bucket] = start;
+    offsets[bucket] = start;
+    start += counts[bucket];
+  }
+
+  //Places every particle in its group
+  for (int i = 0; i < count_; i++) {
+    int fade = min((int) (life_[i] * kFadeLevels), kFadeLevels - 1);
+    batch_[offsets[colour_[i] * kFadeLevels + fade]++] = {(int) x_[i], (int) y_[i]};
+  }
+
+  //Draws each group with a single call, dimmer the more faded it is
+  for (int bucket = 0; bucket < kPaletteSize * kFadeLevels; bucket++) {
+    if (counts[bucket] == 0) {
+      continue;
+    }
+    const Uint8* colour = palette[bucket / kFadeLevels];
+    int brightness = bucket % kFadeLevels + 1;
+    SDL_SetRenderDrawColor(r, colour[0] * brightness / kFadeLevels, colour[1] * brightness / kFadeLevels, colour[2] * brightness / kFadeLevels, 255);
+    SDL_RenderDrawPoints(r, &batch_[starts[bucket]], counts[bucket]);
+  }
+}
+
+int ParticleSystem::size() const noexcept {
+  //Returns the number of live particles
+  return count_;
+}
+
+uint32_t ParticleSystem::nextRandom() noexcept {
+  //Marsaglia's 32 bit xorshift
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+void ParticleSystem::emit(float x, float y, float vx, float vy, int lifetime, Palette colour) noexcept {
+  //A full pool drops new particles rather than growing
+  if (count_ == capacity_) {
+    return;
+  }
+
+  x_[count_] = x;
+  y_[count_] = y;
+  vx_[count_] = vx;
+  vy_[count_] = vy;
+  life_[count_] = 1;
+  decay_[count_] = 1.0f / lifetime;
+  colour_[count_] = colour;
+  count_++;
+}
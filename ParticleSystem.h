@@ -0,0 +1,134 @@
+#ifndef ASTEROIDS_PARTICLESYSTEM_H
+#define ASTEROIDS_PARTICLESYSTEM_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+namespace asteroids {
+
+/**
+ * A fixed capacity pool of short lived particles used for explosions and the
+ * ship's thrust. Particles are stored as parallel arrays so a whole frame of
+ * them is moved and faded in a single pass, and they are drawn with one point
+ * batch per colour. All of the storage is allocated up front, emitting into a
+ * full pool simply drops the new particles.
+ *
+ * @author Jai Aslam
+ */
+class ParticleSystem {
+public:
+  /** The colours particles can be drawn in */
+  enum Palette : std::uint8_t {
+    /** The green of an asteroid breaking apart */
+    PaletteDebris = 0,
+
+    /** The orange of the ship's exhaust */
+    PaletteExhaust = 1
+  };
+
+  /**
+  * Constructs a particle pool which can hold the given number of live particles.
+  */
+  ParticleSystem(/** The most particles alive at once, 0 disables particles */int capacity);
+
+  /**
+  * Destructs the particle pool.
+  */
+  ~ParticleSystem();
+
+  /**
+  * Emits a burst of debris from an asteroid that was destroyed. Bigger
+  * asteroids throw out more debris.
+  */
+  void emitExplosion(/** The x coordinate of the asteroid */int x, /** The y coordinate of the asteroid */int y, /** The radius of the asteroid */int radius) noexcept;
+
+  /**
+  * Emits a puff of exhaust out of the back of a ship moving in the given direction.
+  */
+  void emitThrust(/** The x coordinate of the ship */int x, /** The y coordinate of the ship */int y, /** The angle in radians the ship is moving in */float angle) noexcept;
+
+  /**
+  * Replaces the particles in this pool with a copy of the live particles of
+  * another. Copies no more than this pool can hold and never allocates.
+  */
+  void copyFrom(/** The pool to copy */const ParticleSystem& other) noexcept;
+
+  /**
+  * Moves every particle along its velocity, fades it, and removes the ones
+  * that have faded out.
+  */
+  void update() noexcept;
+
+  /**
+  * Draws every live particle to the given renderer.
+  */
+  void draw(/** The renderer to draw the particles on */SDL_Renderer* r) noexcept;
+
+  /**
+  * @returns the number of live particles.
+  */
+  int size() const noexcept;
+
+private:
+  /** The number of brightness levels a particle fades through */
+  static constexpr int kFadeLevels = 4;
+
+  /** The number of colours in the palette */
+  static constexpr int kPaletteSize = 2;
+
+  /** The number of directions particles can be thrown in */
+  static constexpr int kDirections = 64;
+
+  /** The most particles alive at once */
+  const int capacity_;
+
+  /** The number of live particles, which are always the first count_ of each array */
+  int count_ = 0;
+
+  /** The x coordinate of each particle */
+  std::vector<float> x_;
+
+  /** The y coordinate of each particle */
+  std::vector<float> y_;
+
+  /** The x component of the velocity of each particle */
+  std::vector<float> vx_;
+
+  /** The y component of the velocity of each particle */
+  std::vector<float> vy_;
+
+  /** How much life each particle has left, from 1 when emitted down to 0 */
+  std::vector<float> life_;
+
+  /** How much life each particle loses every tick */
+  std::vector<float> decay_;
+
+  /** The palette colour of each particle */
+  std::vector<std::uint8_t> colour_;
+
+  /** The points being drawn, grouped by colour and brightness */
+  std::vector<SDL_Point> batch_;
+
+  /** The cosine of each direction particles can be thrown in */
+  float cos_[kDirections];
+
+  /** The sine of each direction particles can be thrown in */
+  float sin_[kDirections];
+
+  /** The state of the random number generator used to scatter particles */
+  std::uint32_t random_ = 0x9e3779b9;
+
+  /**
+  * @returns the next random number, a cheap xorshift since particles are only for show.
+  */
+  std::uint32_t nextRandom() noexcept;
+
+  /**
+  * Adds a particle to the pool if there is room for it.
+  */
+  void emit(/** The x coordinate */float x, /** The y coordinate */float y, /** The x velocity */float vx, /** The y velocity */float vy, /** Ticks until it fades out */int lifetime, /** Its colour */Palette colour) noexcept;
+};
+}
+
+#endif
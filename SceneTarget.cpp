@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "SceneTarget.h"
+
+using namespace std;
+using namespace asteroids;
+
+SceneTarget::SceneTarget(int gameWidth, int gameHeight, int windowWidth, int windowHeight, int divisor) noexcept
+  : gameWidth_(gameWidth), gameHeight_(gameHeight), windowWidth_(windowWidth), windowHeight_(windowHeight), divisor_(max(divisor, 1)) {
+
+  //The game fills the window one way and is centered the other, keeping
+  //its shape
+  viewport_ = {0, 0, windowWidth_, windowHeight_};
+  if ((long) windowWidth_ * gameHeight_ > (long) windowHeight_ * gameWidth_) {
+    viewport_.w = (long) windowHeight_ * gameWidth_ / gameHeight_;
+  }
+  else {
+    viewport_.h = (long) windowWidth_ * gameHeight_ / gameWidth_;
+  }
+
+  //The texture is a whole number of times smaller than that so every pixel
+  //of it covers the same square of window pixels
+  width_ = max(viewport_.w / divisor_, 1);
+  height_ = max(viewport_.h / divisor_, 1);
+  viewport_.w = width_ * divisor_;
+  viewport_.h = height_ * divisor_;
+  viewport_.x = (windowWidth_ - viewport_.w) / 2;
+  viewport_.y = (windowHeight_ - viewport_.h) / 2;
+}
+
+SceneTarget::~SceneTarget() {
+  //Frees the texture
+  close();
+}
+
+bool SceneTarget::needed() const noexcept {
+  //A window the size of the game drawn at full resolution needs no texture
+  return divisor_ > 1 || windowWidth_ != gameWidth_ || windowHeight_ != gameHeight_;
+}
+
+void SceneTarget::open(SDL_Renderer* r) {
+  if (!needed()) {
+    return;
+  }
+
+  //Creates the texture and has it scaled up without blurring
+  texture_ = SDL_CreateTexture(r, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width_, height_);
+  if (!texture_) {
+    throw domain_error(string("Unable to create the scene texture due to: ") + SDL_GetError());
+  }
+  SDL_SetTextureScaleMode(texture_, SDL_ScaleModeNearest);
+}
+
+void SceneTarget::close() noexcept {
+  //Destroys the texture and sets it to nullptr to ensure idempotence
+  if (texture_) {
+    SDL_DestroyTexture(texture_);
+    texture_ = nullptr;
+  }
+}
+
+void SceneTarget::begin(SDL_Renderer* r) {
+  if (!texture_) {
+    return;
+  }
+
+  //Switching targets resets the scale, so it is set again every frame
+  if (SDL_SetRenderTarget(r, texture_) != 0) {
+    throw domain_error(string("Unable to draw into the scene texture due to: ") + SDL_GetError());
+  }
+  float textureScale = min((float) width_ / gameWidth_, (float) height_ / gameHeight_);
+  SDL_RenderSetScale(r, textureScale, textureScale);
+}
+
+void SceneTarget::present(SDL_Renderer* r) {
+  if (!texture_) {
+    return;
+  }
+
+  if (SDL_SetRenderTarget(r, nullptr) != 0) {
+    throw domain_error(string("Unable to draw onto the window due to: ") + SDL_GetError());
+  }
+  SDL_RenderSetScale(r, 1, 1);
+
+  //A window of another shape, or which is not a whole multiple of the
+  //texture, has bars left over around the copy, which are cleared to the
+  //background
+  if (viewport_.w != windowWidth_ || viewport_.h != windowHeight_) {
+    SDL_SetRenderDrawColor(r, 0x00, 0x00, 0x00, 0x00);
+    SDL_RenderClear(r);
+  }
+  SDL_RenderCopy(r, texture_, NULL, &viewport_);
+}
+
+void SceneTarget::beginWindow(SDL_Renderer* r) {
+  //Draws in window pixels, the callers place things with toWindow
+  SDL_RenderSetScale(r, 1, 1);
+}
+
+float SceneTarget::scale() const noexcept {
+  //The viewport has the game's shape, so either side gives the scale
+  return (float) viewport_.w / gameWidth_;
+}
+
+SDL_Rect SceneTarget::toWindow(const SDL_Rect& rect) const noexcept {
+  //Scales the rectangle and moves it into the viewport
+  float windowScale = scale();
+  return {viewport_.x + (int) (rect.x * windowScale), viewport_.y + (int) (rect.y * windowScale), (int) (rect.w * windowScale), (int) (rect.h * windowScale)};
+}
@@ -0,0 +1,108 @@
+#ifndef ASTEROIDS_SCENETARGET_H
+#define ASTEROIDS_SCENETARGET_H
+
+#include <SDL2/SDL.h>
+
+namespace asteroids {
+
+/**
+ * Draws the game at a fraction of the window's resolution and scales the
+ * result up to fill the window. The lines of the game are cheap but the
+ * software renderer pays for every pixel they cover, so a large window
+ * drawn at full resolution costs far more than the game needs. Drawing into
+ * a texture a whole number of times smaller than the window and copying it
+ * out once with nearest neighbour scaling keeps the cost of a frame close
+ * to that of the smaller size, and keeps the lines crisp.
+ *
+ * Everything is drawn in the game's coordinates whatever the sizes, the
+ * target scales them into the texture and onto the window. The game keeps
+ * its shape, so a window of a different shape shows black bars either side
+ * or above and below.
+ *
+ * @author Jai Aslam
+ */
+class SceneTarget {
+public:
+  /**
+  * Constructs a target which does nothing until it is opened.
+  */
+  SceneTarget(/** The width of the game */int gameWidth, /** The height of the game */int gameHeight, /** The width of the window */int windowWidth, /** The height of the window */int windowHeight, /** How many times smaller than the window the game is drawn */int divisor) noexcept;
+
+  /**
+  * Destructs the target.
+  */
+  ~SceneTarget();
+
+  /**
+  * @returns whether the game has to be drawn through a texture, rather than
+  * straight onto a window the same size as the game.
+  */
+  bool needed() const noexcept;
+
+  /**
+  * Creates the texture the game is drawn into, if it is needed.
+  */
+  void open(/** The renderer, which must support render targets */SDL_Renderer* r);
+
+  /**
+  * Destroys the texture. Calling it again does nothing.
+  */
+  void close() noexcept;
+
+  /**
+  * Directs drawing into the texture, in the game's coordinates.
+  */
+  void begin(/** The renderer */SDL_Renderer* r);
+
+  /**
+  * Directs drawing back to the window and scales the texture up onto it.
+  */
+  void present(/** The renderer */SDL_Renderer* r);
+
+  /**
+  * Directs drawing onto the window at its own resolution, for text which
+  * should stay sharp. Places in the game are found with toWindow.
+  */
+  void beginWindow(/** The renderer */SDL_Renderer* r);
+
+  /**
+  * @returns how many window pixels one unit of the game covers.
+  */
+  float scale() const noexcept;
+
+  /**
+  * @returns where the given rectangle of the game ends up on the window.
+  */
+  SDL_Rect toWindow(/** The rectangle in the game's coordinates */const SDL_Rect& rect) const noexcept;
+
+private:
+  /** The width of the game */
+  const int gameWidth_;
+
+  /** The height of the game */
+  const int gameHeight_;
+
+  /** The width of the window */
+  const int windowWidth_;
+
+  /** The height of the window */
+  const int windowHeight_;
+
+  /** How many times smaller than the window the game is drawn */
+  const int divisor_;
+
+  /** The part of the window the game fills */
+  SDL_Rect viewport_;
+
+  /** The texture the game is drawn into */
+  SDL_Texture* texture_ = nullptr;
+
+  /** The width of the texture */
+  int width_ = 0;
+
+  /** The height of the texture */
+  int height_ = 0;
+};
+}
+
+#endif
@@ -1,26 +1,26 @@
-#include <math.h>
 #include "Ship.h"
 
 using namespace std;
 using namespace asteroids;
 
 Ship::Ship(int initialX, int initialY, int size) {
-  //Sets the initial coordinates and size of the ship
-  x_ = initialX;
-  y_ = initialY;
+  //Sets the initial coordinates and size of the ship, facing right
+  position_ = FixedVector::fromInt(initialX, initialY);
+  angle_ = 0;
+  heading_ = unitVector(angle_);
   size_ = size;
 }
 
 Ship::~Ship() {}
 
 int Ship::getX() const noexcept {
-  //Returns the current x coordinate
-  return x_;
+  //Returns the current x coordinate to the nearest pixel
+  return position_.x.round();
 }
 
 int Ship::getY() const noexcept {
-  //Returns the current y coordinate
-  return y_;
+  //Returns the current y coordinate to the nearest pixel
+  return position_.y.round();
 }
 
 int Ship::getAngle() const noexcept {
@@ -28,12 +28,15 @@ int Ship::getAngle() const noexcept {
   return angle_;
 }
 
+const FixedVector& Ship::getPosition() const noexcept {
+  //Returns the exact position
+  return position_;
+}
+
 void Ship::updatePosition(int velocityMagnitude) noexcept {
-  //Updates x position using the x-component of velocity
-  x_ += (velocityMagnitude * cos(angle_));
- 
-  //Updates y position using the y-component of velocity
-  y_ += (velocityMagnitude * sin(angle_));
+  //Moves along the direction the ship is facing, keeping the fraction of a
+  //pixel for next time
+  position_ += heading_ * velocityMagnitude;
   
   //Wraps the ship's movement around the screen
   wrapAroundScreen();
@@ -43,12 +46,16 @@ void Ship::updateAngle(int radiansToRotate) noexcept {
   angle_ += radiansToRotate;
   //No higher than 2pi = 6.28
   angle_ %= 6; 
+  heading_ = unitVector(angle_);
 }
 
-bool Ship::collides(shared_ptr<Asteroid> ast) const noexcept {
+bool Ship::collides(const Asteroid& ast) const noexcept {
  //Gives the asteroid and ship a bounding circle and checks
  //if the cirlces intersect
- return pow(ast->getRadius() + size_, 2) >= pow(getX() - ast->getX(), 2) + pow(getY() - ast->getY(), 2);
+ int reach = ast.getRadius() + size_;
+ int dx = getX() - ast.getX();
+ int dy = getY() - ast.getY();
+ return reach * reach >= dx * dx + dy * dy;
 }
 
 
@@ -89,7 +96,7 @@ void Ship::draw(SDL_Renderer* r) noexcept {
   SDL_RenderDrawLines(r, shipSide2, 2);
   
   //Draw the back of the ship in red
-  SDL_SetRenderDrawColor(r, 255, 0, 0, 0);
+  SDL_SetRenderDrawColor(r, 255, 0, 0, 255);
   SDL_RenderDrawLines(r, shipBack, 2);
    
 }
@@ -102,8 +109,9 @@ SDL_Point Ship::rotateAboutCenter(int pointX, int pointY, int angle) noexcept {
 
   //Translation according to the center as well as applying the 2D rotation matrix
   //to the position vector
-  int finalX = cos(angle) * (pointX - centerX) - sin(angle) * (pointY - centerY) + centerX;
-  int finalY = sin(angle) * (pointX - centerX) + cos(angle) * (pointY - centerY) + centerY;
+  FixedVector rotated = rotate(FixedVector::fromInt(pointX - centerX, pointY - centerY), angle);
+  int finalX = rotated.x.round() + centerX;
+  int finalY = rotated.y.round() + centerY;
 
   //Packages and returns the new point in an SDL_Point.
   SDL_Point rotatedPoint = {finalX, finalY};
@@ -113,22 +121,22 @@ SDL_Point Ship::rotateAboutCenter(int pointX, int pointY, int angle) noexcept {
 void Ship::wrapAroundScreen() noexcept {
   //Checks if the ship has gone off the left of the screen
   //if so puts it on the right side of the screen
-  if (x_ < 0) {
-    x_ = 640 + x_;
+  if (position_.x < Fixed::fromInt(0)) {
+    position_.x += Fixed::fromInt(640);
   }
   //Checks if the ship has gone off the right side of the screen
   //if so puts it on the left side of the screen
-  if (x_ > 640) {
-    x_ %= 640;
+  if (position_.x > Fixed::fromInt(640)) {
+    position_.x -= Fixed::fromInt(640);
   }
   //Checks if the ship has gone off the bottom of the screen
   //if so puts the ship on the top of the screen
-  if (y_ < 0) {
-    y_ = 480 + y_;
+  if (position_.y < Fixed::fromInt(0)) {
+    position_.y += Fixed::fromInt(480);
   }
   //Checks if the ship has gone off the top of the screen
   //if so puts it on the bottom of the screen
-  if (y_ > 480) {
-    y_ %= 480;
+  if (position_.y > Fixed::fromInt(480)) {
+    position_.y -= Fixed::fromInt(480);
   }
 }
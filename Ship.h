@@ -7,6 +7,7 @@
 
 #include "Bullet.h"
 #include "Asteroid.h"
+#include "Fixed.h"
 
 namespace asteroids {
 
@@ -45,6 +46,11 @@ public:
   */
   int getAngle() const noexcept;
 
+  /**
+  * @returns the current position of the ship to a fraction of a pixel.
+  */
+  const FixedVector& getPosition() const noexcept;
+
   /**
   * Updates the current position of the ship given
   * the magnitude of the velocity vector.   
@@ -60,7 +66,7 @@ public:
   /**
   * Checks if a ship is colliding with the given asteroid. 
   */
-  bool collides(/** The asteroid to check if the ship is colliding with it */std::shared_ptr<Asteroid> ast) const noexcept;
+  bool collides(/** The asteroid to check if the ship is colliding with it */const Asteroid& ast) const noexcept;
 
   
   /**
@@ -75,15 +81,15 @@ public:
 
 
 private:
-  /** The current x coordinate of the ship. */
-  int x_;
- 
-  /** The current y coordinate of the ship. */
-  int y_;
+  /** The current position of the ship. */
+  FixedVector position_;
 
   /** How far the ship has been rotated currently in radians. */
   int angle_;
 
+  /** The unit vector pointing where the front of the ship is facing. */
+  FixedVector heading_;
+
   /** The size of the ship. This is the distance between the centroid
   * and the front of the ship. */
   int size_;
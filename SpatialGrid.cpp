@@ -0,0 +1,151 @@
+#include <algorithm>
+
+#include "SpatialGrid.h"
+
+using namespace std;
+using namespace asteroids;
+
+SpatialGrid::SpatialGrid(int width, int height, int cellSize)
+  : cellSize_(cellSize), columns_((width + cellSize - 1) / cellSize), rows_((height + cellSize - 1) / cellSize),
+    cellStart_(columns_ * rows_ + 1, 0) {}
+
+SpatialGrid::~SpatialGrid() {}
+
+void SpatialGrid::reserve(int count) noexcept {
+  //Keeps building from growing the lists
+  cellOf_.reserve(count);
+  items_.reserve(count);
+}
+
+void SpatialGrid::build(const vector<Asteroid>& asteroids) noexcept {
+  asteroids_ = &asteroids;
+  cellOf_.resize(asteroids.size());
+  items_.resize(asteroids.size());
+
+  //Counts the asteroids in each cell, shifted by one so the running total
+  //below leaves each cell's start in its own entry
+  fill(cellStart_.begin(), cellStart_.end(), 0);
+  maxRadius_ = 0;
+  for (unsigned i = 0; i < asteroids.size(); i++) {
+    int cell = row(asteroids[i].getY()) * columns_ + column(asteroids[i].getX());
+    cellOf_[i] = cell;
+    cellStart_[cell + 1]++;
+    maxRadius_ = max(maxRadius_, asteroids[i].getRadius());
+  }
+  for (unsigned cell = 1; cell < cellStart_.size(); cell++) {
+    cellStart_[cell] += cellStart_[cell - 1];
+  }
+
+  //Places each asteroid in its cell's slice, using the slice starts as
+  //cursors and then winding them back
+  for (unsigned i = 0; i < asteroids.size(); i++) {
+    items_[cellStart_[cellOf_[i]]++] = i;
+  }
+  for (int cell = columns_ * rows_; cell > 0; cell--) {
+    cellStart_[cell] = cellStart_[cell - 1];
+  }
+  cellStart_[0] = 0;
+}
+
+int SpatialGrid::query(int x, int y, int range, int* out, int max) const noexcept {
+  if (!asteroids_) {
+    return 0;
+  }
+
+  //Any asteroid within range has its center within range plus the largest radius
+  int reach = range + maxRadius_;
+  int found = 0;
+  for (int r = row(y - reach); r <= row(y + reach); r++) {
+    for (int c = column(x - reach); c <= column(x + reach); c++) {
+      int cell = r * columns_ + c;
+      for (int item = cellStart_[cell]; item < cellStart_[cell + 1]; item++) {
+        //Keeps the asteroid if its outline is within range of the point
+        const Asteroid& ast = (*asteroids_)[items_[item]];
+        int dx = ast.getX() - x;
+        int dy = ast.getY() - y;
+        int limit = range + ast.getRadius();
+        if (dx * dx + dy * dy <= limit * limit) {
+          if (found == max) {
+            return found;
+          }
+          out[found++] = items_[item];
+        }
+      }
+    }
+  }
+  return found;
+}
+
+int SpatialGrid::nearest(int x, int y, int k, int* out) const noexcept {
+  if (!asteroids_) {
+    return 0;
+  }
+  k = min(k, kMaxNearest);
+
+  //The closest asteroids found so far, nearest first
+  int bestDistance[kMaxNearest];
+  int bestIndex[kMaxNearest];
+  int found = 0;
+
+  //Searches rings of cells outwards from the point's cell
+  int centerRow = row(y);
+  int centerColumn = column(x);
+  int rings = std::max(rows_, columns_);
+  for (int ring = 0; ring < rings; ring++) {
+    //Nothing in this ring or beyond can be closer than the k already found
+    if (found == k && (long) (ring - 1) * cellSize_ * (ring - 1) * cellSize_ > bestDistance[found - 1]) {
+      break;
+    }
+
+    for (int r = centerRow - ring; r <= centerRow + ring; r++) {
+      if (r < 0 || r >= rows_) {
+        continue;
+      }
+      for (int c = centerColumn - ring; c <= centerColumn + ring; c++) {
+        //Only the cells on the edge of the ring are new
+        if (c < 0 || c >= columns_ || (abs(r - centerRow) != ring && abs(c - centerColumn) != ring)) {
+          continue;
+        }
+
+        int cell = r * columns_ + c;
+        for (int item = cellStart_[cell]; item < cellStart_[cell + 1]; item++) {
+          const Asteroid& ast = (*asteroids_)[items_[item]];
+          int dx = ast.getX() - x;
+          int dy = ast.getY() - y;
+          int distance = dx * dx + dy * dy;
+
+          //Inserts the asteroid into the sorted list if it is close enough
+          if (found == k && distance >= bestDistance[found - 1]) {
+            continue;
+          }
+          int slot = found < k ? found++ : found - 1;
+          while (slot > 0 && bestDistance[slot - 1] > distance) {
+            bestDistance[slot] = bestDistance[slot - 1];
+            bestIndex[slot] = bestIndex[slot - 1];
+            slot--;
+          }
+          bestDistance[slot] = distance;
+          bestIndex[slot] = items_[item];
+        }
+      }
+    }
+  }
+
+  copy_n(bestIndex, found, out);
+  return found;
+}
+
+const vector<Asteroid>& SpatialGrid::asteroids() const noexcept {
+  //Returns the indexed asteroids
+  return *asteroids_;
+}
+
+int SpatialGrid::column(int x) const noexcept {
+  //Asteroids drift past the edges before wrapping so they go in the edge cells
+  return min(max(x / cellSize_, 0), columns_ - 1);
+}
+
+int SpatialGrid::row(int y) const noexcept {
+  //Asteroids drift past the edges before wrapping so they go in the edge cells
+  return min(max(y / cellSize_, 0), rows_ - 1);
+}
@@ -0,0 +1,101 @@
+#ifndef ASTEROIDS_SPATIALGRID_H
+#define ASTEROIDS_SPATIALGRID_H
+
+#include <vector>
+
+#include "Asteroid.h"
+
+namespace asteroids {
+
+/**
+ * A uniform grid over the screen that indexes asteroids by the cell their
+ * center is in, so questions about the asteroids near a point only look at
+ * the handful of cells around it instead of every asteroid. The grid is
+ * rebuilt from scratch each tick with a counting sort into flat arrays,
+ * which reuse their storage from one tick to the next.
+ *
+ * @author Jai Aslam
+ */
+class SpatialGrid {
+public:
+  /**
+  * Constructs an empty grid covering a screen of the given size.
+  */
+  SpatialGrid(/** The width of the screen */int width, /** The height of the screen */int height, /** The width and height of a cell */int cellSize);
+
+  /**
+  * Destructs the grid.
+  */
+  ~SpatialGrid();
+
+  /**
+  * Indexes the given asteroids, replacing whatever was indexed before. The
+  * indices handed out by queries refer to this vector.
+  */
+  void build(/** The asteroids to index */const std::vector<Asteroid>& asteroids) noexcept;
+
+  /**
+  * Makes room to index the given number of asteroids.
+  */
+  void reserve(/** The number of asteroids */int count) noexcept;
+
+  /**
+  * Finds the asteroids whose outline comes within the given distance of a point.
+  *
+  * @returns the number of asteroid indices written, at most max.
+  */
+  int query(/** The x coordinate of the point */int x, /** The y coordinate of the point */int y, /** The distance from the point */int range, /** Receives the indices */int* out, /** The most indices written */int max) const noexcept;
+
+  /**
+  * Finds the k asteroids with centers closest to a point, nearest first.
+  *
+  * @returns the number of asteroid indices written, at most k.
+  */
+  int nearest(/** The x coordinate of the point */int x, /** The y coordinate of the point */int y, /** The number of asteroids wanted */int k, /** Receives the indices */int* out) const noexcept;
+
+  /**
+  * @returns the asteroids the grid was last built from.
+  */
+  const std::vector<Asteroid>& asteroids() const noexcept;
+
+private:
+  /** The most asteroids a nearest query can return */
+  static constexpr int kMaxNearest = 16;
+
+  /** The width and height of a cell */
+  const int cellSize_;
+
+  /** The number of columns */
+  const int columns_;
+
+  /** The number of rows */
+  const int rows_;
+
+  /** The largest radius of any indexed asteroid */
+  int maxRadius_ = 0;
+
+  /** The asteroids the grid was last built from */
+  const std::vector<Asteroid>* asteroids_ = nullptr;
+
+  /** Where each cell's asteroids start in items_, with one extra entry marking the end */
+  std::vector<int> cellStart_;
+
+  /** The cell each asteroid is in */
+  std::vector<int> cellOf_;
+
+  /** The asteroid indices, grouped by cell */
+  std::vector<int> items_;
+
+  /**
+  * @returns the cell column of the given x coordinate, clamped to the grid.
+  */
+  int column(/** The x coordinate */int x) const noexcept;
+
+  /**
+  * @returns the cell row of the given y coordinate, clamped to the grid.
+  */
+  int row(/** The y coordinate */int y) const noexcept;
+};
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include <algorithm>
+
+#include "SpawnPlacer.h"
+
+using namespace std;
+using namespace asteroids;
+
+SpawnPlacer::SpawnPlacer(int width, int height) : width_(width), height_(height) {}
+
+SpawnPlacer::~SpawnPlacer() {}
+
+void SpawnPlacer::begin(int radius) noexcept {
+  radius_ = max(radius, 1);
+
+  //Two asteroids closer than twice the radius overlap, and with cells that
+  //size over the square root of two a cell can only ever hold one of them
+  cellSize_ = max(radius_ * 2 * 1000 / 1415, 1);
+  columns_ = width_ / cellSize_ + 1;
+  rows_ = height_ / cellSize_ + 1;
+  cells_.assign(columns_ * rows_, -1);
+  placed_.clear();
+}
+
+void SpawnPlacer::reserve(int count) noexcept {
+  //Keeps placing the wave from growing the list
+  placed_.reserve(count);
+}
+
+void SpawnPlacer::avoid(int x, int y, int safeRadius) noexcept {
+  //Remembers the spot to keep clear
+  avoided_.push_back({x, y, safeRadius});
+}
+
+void SpawnPlacer::clearAvoided() noexcept {
+  //Keeps the storage for the next spots
+  avoided_.clear();
+}
+
+SDL_Point SpawnPlacer::place(minstd_rand& random) noexcept {
+  //Asteroids stay fully on the screen where it is big enough to hold them
+  int spanX = max(width_ - 2 * radius_, 1);
+  int spanY = max(height_ - 2 * radius_, 1);
+
+  SDL_Point fallback = {-1, -1};
+  int fallbackClear = 0;
+  int zones = avoided_.size();
+  for (int attempt = 0; attempt < kAttempts; attempt++) {
+    //The random numbers are drawn in separate statements so the order they
+    //are drawn in does not depend on the compiler
+    int x = random() % spanX + radius_;
+    int y = random() % spanY + radius_;
+    int clear = clearOf(x, y);
+    if (clear == zones && !crowded(x, y)) {
+      add(x, y);
+      return {x, y};
+    }
+
+    //Any other spot clear of at least the first zone is kept in case nothing
+    //better turns up, preferring one clear of every zone, so overlapping
+    //another asteroid, then one clear of more of the zones given first
+    if ((clear > 0 || zones == 0) && clear >= fallbackClear) {
+      fallback = {x, y};
+      fallbackClear = clear;
+    }
+  }
+
+  //The screen is too full, so the asteroid overlaps another or a ship's
+  //zone but still keeps clear of the first ship if any spot did, and only
+  //drops that as a last resort
+  if (fallback.x < 0) {
+    fallback.x = random() % spanX + radius_;
+    fallback.y = random() % spanY + radius_;
+  }
+  add(fallback.x, fallback.y);
+  return fallback;
+}
+
+int SpawnPlacer::clearOf(int x, int y) const noexcept {
+  //Counts the zones in order until the first one reached into
+  int clear = 0;
+  for (const SafeZone& zone : avoided_) {
+    long dx = x - zone.x;
+    long dy = y - zone.y;
+    long reach = zone.safeRadius + radius_;
+    if (dx * dx + dy * dy < reach * reach) {
+      break;
+    }
+    clear++;
+  }
+  return clear;
+}
+
+bool SpawnPlacer::crowded(int x, int y) const noexcept {
+  //Anything close enough to overlap is within two cells either way
+  int column = min(x / cellSize_, columns_ - 1);
+  int row = min(y / cellSize_, rows_ - 1);
+  long spacing = 2 * radius_;
+  for (int r = max(row - 2, 0); r <= min(row + 2, rows_ - 1); r++) {
+    for (int c = max(column - 2, 0); c <= min(column + 2, columns_ - 1); c++) {
+      int index = cells_[r * columns_ + c];
+      if (index < 0) {
+        continue;
+      }
+      long dx = placed_[index].x - x;
+      long dy = placed_[index].y - y;
+      if (dx * dx + dy * dy < spacing * spacing) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void SpawnPlacer::add(int x, int y) noexcept {
+  //An asteroid that had to overlap another may find its cell taken, it
+  //still counts but the grid only needs one asteroid per cell to keep the
+  //rest of the wave off it
+  int cell = min(y / cellSize_, rows_ - 1) * columns_ + min(x / cellSize_, columns_ - 1);
+  placed_.push_back({x, y});
+  if (cells_[cell] < 0) {
+    cells_[cell] = placed_.size() - 1;
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef ASTEROIDS_SPAWNPLACER_H
+#define ASTEROIDS_SPAWNPLACER_H
+
+#include <SDL2/SDL.h>
+#include <random>
+#include <vector>
+
+namespace asteroids {
+
+/**
+ * Picks where the asteroids of a wave appear: fully on the screen, not on
+ * top of each other and not within a safe distance of any ship.
+ *
+ * Candidate spots are drawn at random and checked against a background grid
+ * whose cells are small enough to hold at most one asteroid each, so a check
+ * only looks at the few cells around the spot. Placing a whole wave takes
+ * time close to linear in the number of asteroids. Once the screen is too
+ * full for another asteroid to fit without overlapping, asteroids are still
+ * kept off the ships and the screen edges but may overlap each other.
+ *
+ * @author Jai Aslam
+ */
+class SpawnPlacer {
+public:
+  /**
+  * Constructs a placer for a screen of the given size.
+  */
+  SpawnPlacer(/** The width of the screen */int width, /** The height of the screen */int height);
+
+  /**
+  * Destructs the placer.
+  */
+  ~SpawnPlacer();
+
+  /**
+  * Forgets every asteroid placed so far and starts placing a wave of
+  * asteroids of the given radius.
+  */
+  void begin(/** The radius of the asteroids */int radius) noexcept;
+
+  /**
+  * Makes room for a wave of the given number of asteroids.
+  */
+  void reserve(/** The number of asteroids */int count) noexcept;
+
+  /**
+  * Keeps new asteroids away from the given spot, usually a ship, as well as
+  * from the spots given before it. When the screen is too full to keep clear
+  * of them all, the spots given first are kept clear of first.
+  */
+  void avoid(/** The x coordinate of the spot */int x, /** The y coordinate of the spot */int y, /** How far from the spot the edge of an asteroid must stay */int safeRadius) noexcept;
+
+  /**
+  * Forgets every spot to avoid, keeping the storage.
+  */
+  void clearAvoided() noexcept;
+
+  /**
+  * @returns the center of the next asteroid of the wave.
+  */
+  SDL_Point place(/** Draws the candidate spots */std::minstd_rand& random) noexcept;
+
+private:
+  /** The candidate spots tried before letting an asteroid overlap others */
+  static constexpr int kAttempts = 30;
+
+  /** The width of the screen */
+  const int width_;
+
+  /** The height of the screen */
+  const int height_;
+
+  /** The radius of the asteroids being placed */
+  int radius_ = 1;
+
+  /** The width and height of a grid cell */
+  int cellSize_ = 1;
+
+  /** The number of grid columns */
+  int columns_ = 0;
+
+  /** The number of grid rows */
+  int rows_ = 0;
+
+  /** The asteroid in each cell as an index into placed_, -1 if empty */
+  std::vector<int> cells_;
+
+  /** The centers of the asteroids placed so far */
+  std::vector<SDL_Point> placed_;
+
+  /** A spot new asteroids keep away from */
+  struct SafeZone {
+    /** The x coordinate of the spot */
+    int x;
+
+    /** The y coordinate of the spot */
+    int y;
+
+    /** How far from the spot the edge of an asteroid must stay */
+    int safeRadius;
+  };
+
+  /** The spots to keep away from */
+  std::vector<SafeZone> avoided_;
+
+  /**
+  * @returns how many of the safe zones, in the order they were given, an
+  * asteroid centered on the given spot keeps out of before reaching into one.
+  */
+  int clearOf(/** The x coordinate */int x, /** The y coordinate */int y) const noexcept;
+
+  /**
+  * @returns whether an asteroid centered on the given spot would overlap one already placed.
+  */
+  bool crowded(/** The x coordinate */int x, /** The y coordinate */int y) const noexcept;
+
+  /**
+  * Remembers an asteroid placed on the given spot.
+  */
+  void add(/** The x coordinate */int x, /** The y coordinate */int y) noexcept;
+};
+}
+
+#endif
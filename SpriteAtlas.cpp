@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "SpriteAtlas.h"
+#include "MeshLibrary.h"
+#include "LineBatch.h"
+
+using namespace std;
+using namespace asteroids;
+
+SpriteAtlas::SpriteAtlas() noexcept {}
+
+SpriteAtlas::~SpriteAtlas() {
+  //Frees the texture
+  close();
+}
+
+void SpriteAtlas::open(SDL_Renderer* r, int shipSize) {
+  //Lays the shapes out in rows, one row for each size of asteroid and one
+  //for the ship, with a pixel spare round each so none bleed into the next
+  const vector<int>& radii = MeshLibrary::shared().radii();
+  int y = 0;
+  for (int radius : radii) {
+    int side = 2 * radius + 3;
+    for (int variant = 0; variant < MeshLibrary::kVariants; variant++) {
+      asteroids_.push_back({{variant * side, y, side, side}, {radius + 1, radius + 1}});
+    }
+    width_ = max(width_, MeshLibrary::kVariants * side);
+    y += side;
+  }
+  int side = 2 * shipSize + 3;
+  for (int angle = 0; angle < kShipAngles; angle++) {
+    ships_.push_back({{angle * side, y, side, side}, {shipSize + 1, shipSize + 1}});
+  }
+  width_ = max(width_, kShipAngles * side);
+  height_ = y + side;
+
+  //Creates a texture which is see through wherever nothing is drawn
+  texture_ = SDL_CreateTexture(r, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width_, height_);
+  if (!texture_) {
+    throw domain_error(string("Unable to create the sprite atlas due to: ") + SDL_GetError());
+  }
+  SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+  if (SDL_SetRenderTarget(r, texture_) != 0) {
+    close();
+    throw domain_error(string("Unable to draw the sprite atlas due to: ") + SDL_GetError());
+  }
+  SDL_SetRenderDrawColor(r, 0x00, 0x00, 0x00, 0x00);
+  SDL_RenderClear(r);
+
+  //Draws each asteroid with the outline it is drawn with otherwise
+  LineBatch outlines;
+  for (unsigned size = 0; size < radii.size(); size++) {
+    for (int variant = 0; variant < MeshLibrary::kVariants; variant++) {
+      const Sprite& sprite = asteroids_[size * MeshLibrary::kVariants + variant];
+      Asteroid ast(sprite.source.x + sprite.center.x, sprite.source.y + sprite.center.y, radii[size], variant);
+      ast.draw(outlines);
+    }
+  }
+  SDL_SetRenderDrawColor(r, 0, 255, 0, 255);
+  outlines.draw(r, false);
+
+  //Draws the ship at every angle it can point at
+  for (int angle = 0; angle < kShipAngles; angle++) {
+    const Sprite& sprite = ships_[angle];
+    Ship ship(sprite.source.x + sprite.center.x, sprite.source.y + sprite.center.y, shipSize);
+    ship.updateAngle(angle - kShipAngles / 2);
+    ship.draw(r);
+  }
+
+  //Goes back to drawing on the window
+  SDL_SetRenderTarget(r, nullptr);
+}
+
+void SpriteAtlas::close() noexcept {
+  //Destroys the texture and sets it to nullptr to ensure idempotence
+  if (texture_) {
+    SDL_DestroyTexture(texture_);
+    texture_ = nullptr;
+  }
+}
+
+void SpriteAtlas::clear() noexcept {
+  //Keeps the storage for the next frame
+  vertices_.clear();
+  indices_.clear();
+}
+
+void SpriteAtlas::add(const Asteroid& ast) {
+  //Looks up the outline the asteroid would be drawn with
+  int size = MeshLibrary::shared().sizeOf(ast.getRadius());
+  add(asteroids_[size * MeshLibrary::kVariants + abs(ast.getDirection()) % MeshLibrary::kVariants], ast.getX(), ast.getY());
+}
+
+void SpriteAtlas::add(const Ship& ship) {
+  //Looks up the ship at its angle
+  add(ships_[ship.getAngle() + kShipAngles / 2], ship.getX(), ship.getY());
+}
+
+void SpriteAtlas::draw(SDL_Renderer* r) const noexcept {
+  //Hands every square to SDL at once
+  if (texture_ && !indices_.empty()) {
+    SDL_RenderGeometry(r, texture_, vertices_.data(), vertices_.size(), indices_.data(), indices_.size());
+  }
+}
+
+void SpriteAtlas::add(const Sprite& sprite, int x, int y) {
+  //The corners of the square on the screen and in the atlas
+  float left = x - sprite.center.x;
+  float top = y - sprite.center.y;
+  float right = left + sprite.source.w;
+  float bottom = top + sprite.source.h;
+  float u0 = (float) sprite.source.x / width_;
+  float v0 = (float) sprite.source.y / height_;
+  float u1 = (float) (sprite.source.x + sprite.source.w) / width_;
+  float v1 = (float) (sprite.source.y + sprite.source.h) / height_;
+
+  //Two triangles sharing the diagonal, drawn without tinting
+  int first = vertices_.size();
+  SDL_Color white = {255, 255, 255, 255};
+  vertices_.push_back({{left, top}, white, {u0, v0}});
+  vertices_.push_back({{right, top}, white, {u1, v0}});
+  vertices_.push_back({{right, bottom}, white, {u1, v1}});
+  vertices_.push_back({{left, bottom}, white, {u0, v1}});
+  for (int corner : {0, 1, 2, 0, 2, 3}) {
+    indices_.push_back(first + corner);
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef ASTEROIDS_SPRITEATLAS_H
+#define ASTEROIDS_SPRITEATLAS_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "Asteroid.h"
+#include "Ship.h"
+
+namespace asteroids {
+
+/**
+ * Every shape the game draws, drawn once at startup into a single texture.
+ * An asteroid only ever looks one of a few ways, one outline per direction
+ * for each size it can be, and the ship only ever points one of six ways
+ * either side of zero, so each of those is drawn once with the same lines
+ * the outline drawing uses.
+ *
+ * A frame then adds a textured square per ship and asteroid to a batch and
+ * hands the whole batch to SDL in one geometry call, instead of working out
+ * and drawing every line again. Which is cheaper depends on the renderer, so
+ * the game keeps drawing outlines unless sprites are asked for.
+ *
+ * @author Jai Aslam
+ */
+class SpriteAtlas {
+public:
+  /**
+  * Constructs an atlas with nothing drawn yet.
+  */
+  SpriteAtlas() noexcept;
+
+  /**
+  * Destructs the atlas.
+  */
+  ~SpriteAtlas();
+
+  /**
+  * Draws every shape into the atlas texture.
+  */
+  void open(/** The renderer, which must support render targets */SDL_Renderer* r, /** The distance from the center of the ship to its front */int shipSize);
+
+  /**
+  * Destroys the atlas texture. Calling it again does nothing.
+  */
+  void close() noexcept;
+
+  /**
+  * Empties the batch, keeping its storage.
+  */
+  void clear() noexcept;
+
+  /**
+  * Adds the given asteroid to the batch.
+  */
+  void add(/** The asteroid */const Asteroid& ast);
+
+  /**
+  * Adds the given ship to the batch.
+  */
+  void add(/** The ship */const Ship& ship);
+
+  /**
+  * Draws everything in the batch.
+  */
+  void draw(/** The renderer to draw on */SDL_Renderer* r) const noexcept;
+
+private:
+  /** The number of angles the ship can point at, from -5 to 5 */
+  static constexpr int kShipAngles = 11;
+
+  /** Where a shape is in the atlas */
+  struct Sprite {
+    /** The square the shape was drawn in */
+    SDL_Rect source;
+
+    /** The center of the shape relative to the square */
+    SDL_Point center;
+  };
+
+  /** The texture every shape is drawn in */
+  SDL_Texture* texture_ = nullptr;
+
+  /** The width of the texture */
+  int width_ = 0;
+
+  /** The height of the texture */
+  int height_ = 0;
+
+  /** The asteroid outlines, by size then variant */
+  std::vector<Sprite> asteroids_;
+
+  /** The ship at each angle, starting from -5 */
+  std::vector<Sprite> ships_;
+
+  /** The corners of the squares in the batch */
+  std::vector<SDL_Vertex> vertices_;
+
+  /** The corners of the two triangles making up each square */
+  std::vector<int> indices_;
+
+  /**
+  * Adds the given sprite centered on the given point to the batch.
+  */
+  void add(/** The sprite */const Sprite& sprite, /** The x coordinate of the center */int x, /** The y coordinate of the center */int y);
+};
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef ASTEROIDS_SPSCQUEUE_H
+#define ASTEROIDS_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace asteroids {
+
+/**
+ * A bounded queue between exactly one producer thread and one consumer thread.
+ * Pushing and popping are wait-free: neither side ever blocks or retries, a
+ * push onto a full queue and a pop from an empty one simply fail.
+ *
+ * @author Jai Aslam
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+
+public:
+  /**
+  * Adds a value to the back of the queue. Only the producer may call this.
+  *
+  * @returns false if the queue was full and the value was dropped.
+  */
+  bool push(/** The value to add */const T& value) noexcept {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+
+    //Writes the value before making it visible to the consumer
+    slots_[tail & (Capacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+  * Takes the value at the front of the queue. Only the consumer may call this.
+  *
+  * @returns false if the queue was empty.
+  */
+  bool pop(/** Receives the value */T& value) noexcept {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    //Reads the value before handing its slot back to the producer
+    value = slots_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+  * Looks at the value at the front of the queue without taking it. Only the
+  * consumer may call this.
+  *
+  * @returns nullptr if the queue was empty.
+  */
+  const T* peek() const noexcept {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots_[head & (Capacity - 1)];
+  }
+
+private:
+  /** The number of values taken by the consumer, on its own cache line */
+  alignas(64) std::atomic<std::size_t> head_{0};
+
+  /** The number of values added by the producer, on its own cache line */
+  alignas(64) std::atomic<std::size_t> tail_{0};
+
+  /** The ring of values, indexed by the counters modulo the capacity */
+  alignas(64) T slots_[Capacity];
+};
+}
+
+#endif
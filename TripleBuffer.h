@@ -0,0 +1,93 @@
+#ifndef ASTEROIDS_TRIPLEBUFFER_H
+#define ASTEROIDS_TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace asteroids {
+
+/**
+ * Hands the latest value from one writer thread to one reader thread without
+ * either ever waiting on the other. The writer fills the back buffer and
+ * publishes it, the reader picks up whichever buffer was published last.
+ * Values the reader was too slow to see are simply skipped.
+ *
+ * @author Jai Aslam
+ */
+template <typename T>
+class TripleBuffer {
+public:
+  /**
+  * Constructs the three buffers from the same arguments.
+  */
+  template <typename... Args>
+  explicit TripleBuffer(/** The arguments each buffer is constructed with */const Args&... args)
+    : buffers_{T(args...), T(args...), T(args...)} {}
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /**
+  * @returns the buffer the writer fills. Only the writer may touch it.
+  */
+  T& back() noexcept {
+    return buffers_[back_];
+  }
+
+  /**
+  * Publishes the back buffer to the reader and takes the previously
+  * published buffer, or the one the reader gave back, as the new back buffer.
+  */
+  void publish() noexcept {
+    //Swaps the back buffer into the middle, flagging it as new
+    std::uint8_t previous = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+    back_ = previous & kIndex;
+  }
+
+  /**
+  * Takes the most recently published buffer as the front buffer if there is
+  * one the reader has not seen yet.
+  *
+  * @returns whether the front buffer changed.
+  */
+  bool update() noexcept {
+    //Nothing new was published since the last update
+    if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+      return false;
+    }
+
+    //Swaps the front buffer into the middle, marking it as already seen
+    std::uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & kIndex;
+    return true;
+  }
+
+  /**
+  * @returns the buffer the reader uses. Only the reader may touch it.
+  */
+  T& front() noexcept {
+    return buffers_[front_];
+  }
+
+private:
+  /** Masks the buffer index out of the middle slot */
+  static constexpr std::uint8_t kIndex = 3;
+
+  /** Set in the middle slot when it holds a buffer the reader has not seen */
+  static constexpr std::uint8_t kFresh = 4;
+
+  /** The three buffers that rotate between the writer, the middle and the reader */
+  T buffers_[3];
+
+  /** The index of the buffer the writer fills */
+  std::uint8_t back_ = 0;
+
+  /** The index of the buffer waiting in the middle and whether it is fresh */
+  std::atomic<std::uint8_t> middle_{1};
+
+  /** The index of the buffer the reader uses */
+  std::uint8_t front_ = 2;
+};
+}
+
+#endif
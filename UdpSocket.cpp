@@ -0,0 +1,79 @@
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "UdpSocket.h"
+
+using namespace std;
+using namespace asteroids;
+
+UdpSocket::UdpSocket(int port, bool anyInterface) {
+  fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd_ < 0) {
+    throw domain_error(string("Unable to open a UDP socket due to: ") + strerror(errno));
+  }
+
+  //Binds to the port, only reachable from this machine unless asked otherwise
+  sockaddr_in local = address(anyInterface ? "0.0.0.0" : "127.0.0.1", port);
+  if (bind(fd_, (const sockaddr*) &local, sizeof(local)) != 0 || fcntl(fd_, F_SETFL, O_NONBLOCK) != 0) {
+    string reason = strerror(errno);
+    ::close(fd_);
+    throw domain_error(string("Unable to bind UDP port ") + to_string(port) + " due to: " + reason);
+  }
+}
+
+UdpSocket::~UdpSocket() {
+  //Closes the socket
+  ::close(fd_);
+}
+
+void UdpSocket::connect(const sockaddr_in& to) {
+  if (::connect(fd_, (const sockaddr*) &to, sizeof(to)) != 0) {
+    throw domain_error(string("Unable to connect the UDP socket due to: ") + strerror(errno));
+  }
+}
+
+bool UdpSocket::send(const sockaddr_in& to, const uint8_t* data, int size) noexcept {
+  //A full send buffer drops the datagram rather than waiting
+  return sendto(fd_, data, size, 0, (const sockaddr*) &to, sizeof(to)) == size;
+}
+
+int UdpSocket::receive(uint8_t* data, int capacity, sockaddr_in& from) noexcept {
+  socklen_t length = sizeof(from);
+  ssize_t size = recvfrom(fd_, data, capacity, 0, (sockaddr*) &from, &length);
+  return size < 0 ? -1 : (int) size;
+}
+
+int UdpSocket::port() const noexcept {
+  //Asks the operating system which port was picked
+  sockaddr_in local;
+  socklen_t length = sizeof(local);
+  getsockname(fd_, (sockaddr*) &local, &length);
+  return ntohs(local.sin_port);
+}
+
+sockaddr_in UdpSocket::address(const char* host, int port) {
+  sockaddr_in result;
+  memset(&result, 0, sizeof(result));
+  result.sin_family = AF_INET;
+  result.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &result.sin_addr) != 1) {
+    throw domain_error(string("Not an IPv4 address: ") + host);
+  }
+  return result;
+}
+
+bool UdpSocket::sameAddress(const sockaddr_in& a, const sockaddr_in& b) noexcept {
+  //Compares the parts a datagram's sender is known by
+  return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+bool UdpSocket::isLoopback(const sockaddr_in& address) noexcept {
+  //Everything in 127.0.0.0/8 stays on this machine
+  return (ntohl(address.sin_addr.s_addr) >> 24) == 127;
+}
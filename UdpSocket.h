@@ -0,0 +1,80 @@
+#ifndef ASTEROIDS_UDPSOCKET_H
+#define ASTEROIDS_UDPSOCKET_H
+
+#include <cstdint>
+#include <netinet/in.h>
+
+namespace asteroids {
+
+/**
+ * A non-blocking UDP socket. Sending and receiving never wait, a datagram
+ * that cannot be sent right away is dropped the same way the network would
+ * drop it.
+ *
+ * @author Jai Aslam
+ */
+class UdpSocket {
+public:
+  /**
+  * Opens a socket bound to the given port on the loopback interface or any
+  * interface. Throws a domain_error if the socket cannot be opened or bound.
+  */
+  UdpSocket(/** The port to bind, 0 picks any free port */int port, /** Whether to listen on every interface rather than just loopback */bool anyInterface = false);
+
+  /**
+  * Closes the socket.
+  */
+  ~UdpSocket();
+
+  UdpSocket(const UdpSocket&) = delete;
+  UdpSocket& operator=(const UdpSocket&) = delete;
+
+  /**
+  * Only exchanges datagrams with the given address from now on, the
+  * operating system drops any arriving from anywhere else. Throws a
+  * domain_error if the socket cannot be connected.
+  */
+  void connect(/** The only address to talk to */const sockaddr_in& to);
+
+  /**
+  * Sends a datagram to the given address.
+  *
+  * @returns whether the datagram was handed to the operating system.
+  */
+  bool send(/** The address to send to */const sockaddr_in& to, /** The datagram */const std::uint8_t* data, /** The size of the datagram */int size) noexcept;
+
+  /**
+  * Receives the next waiting datagram.
+  *
+  * @returns the size of the datagram, or -1 if none is waiting.
+  */
+  int receive(/** Receives the datagram */std::uint8_t* data, /** The size of the buffer */int capacity, /** Receives the sender's address */sockaddr_in& from) noexcept;
+
+  /**
+  * @returns the port the socket is bound to.
+  */
+  int port() const noexcept;
+
+  /**
+  * @returns the address of the given host and port. Throws a domain_error if
+  * the host is not a dotted IPv4 address.
+  */
+  static sockaddr_in address(/** The host, e.g. 127.0.0.1 */const char* host, /** The port */int port);
+
+  /**
+  * @returns whether the two addresses are the same host and port.
+  */
+  static bool sameAddress(/** One address */const sockaddr_in& a, /** The other address */const sockaddr_in& b) noexcept;
+
+  /**
+  * @returns whether the address is on the loopback interface.
+  */
+  static bool isLoopback(/** The address */const sockaddr_in& address) noexcept;
+
+private:
+  /** The socket's file descriptor */
+  int fd_ = -1;
+};
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include <utility>
+
+#include "WaveDirector.h"
+
+using namespace std;
+using namespace asteroids;
+
+/** The last script frame freed on this thread, kept for the next script */
+static thread_local void* spareFrame = nullptr;
+
+/** The size of the spare frame */
+static thread_local size_t spareSize = 0;
+
+void* WaveScript::promise_type::operator new(size_t size) {
+  //Hands out the spare frame if the script fits in it
+  if (spareFrame && spareSize >= size) {
+    return exchange(spareFrame, nullptr);
+  }
+  return ::operator new(size);
+}
+
+void WaveScript::promise_type::operator delete(void* frame, size_t size) noexcept {
+  //Keeps the frame as the spare if there is none yet
+  if (!spareFrame) {
+    spareFrame = frame;
+    spareSize = size;
+    return;
+  }
+  ::operator delete(frame);
+}
+
+WaveScript::WaveScript(coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+WaveScript::WaveScript(WaveScript&& other) noexcept : handle_(exchange(other.handle_, nullptr)) {}
+
+WaveScript& WaveScript::operator=(WaveScript&& other) noexcept {
+  //Destroys the script being replaced before taking over the other one
+  if (this != &other) {
+    if (handle_) {
+      handle_.destroy();
+    }
+    handle_ = exchange(other.handle_, nullptr);
+  }
+  return *this;
+}
+
+WaveScript::~WaveScript() {
+  //Frees the coroutine frame, suspended or finished
+  if (handle_) {
+    handle_.destroy();
+  }
+}
+
+bool WaveScript::next() noexcept {
+  //An empty or finished script has nothing left to yield
+  if (!handle_ || handle_.done()) {
+    return false;
+  }
+
+  //Runs the script up to its next co_yield or its end
+  handle_.resume();
+  return !handle_.done();
+}
+
+const Asteroid& WaveScript::value() const noexcept {
+  //Returns the asteroid the script is suspended on
+  return *handle_.promise().current;
+}
+
+WaveScript asteroids::asteroidWave(int count, int radius, SpawnPlacer& placer, minstd_rand& random) {
+  //Keeps the asteroids of the wave off each other
+  placer.begin(radius);
+  for (int i = 0; i < count; i++) {
+    //The position is drawn before the direction so the order does not
+    //depend on the compiler
+    SDL_Point center = placer.place(random);
+    int direction = random() % 6;
+    co_yield Asteroid(center.x, center.y, radius, direction);
+  }
+}
+
+WaveDirector::WaveDirector() noexcept {}
+
+void WaveDirector::start(WaveScript script) noexcept {
+  //Replacing the script destroys the one that was running
+  script_ = move(script);
+  active_ = true;
+}
+
+void WaveDirector::stop() noexcept {
+  //Drops the rest of the running wave
+  script_ = WaveScript();
+  active_ = false;
+}
+
+bool WaveDirector::active() const noexcept {
+  //Returns whether there is more of the wave to spawn
+  return active_;
+}
+
+int WaveDirector::spawn(int budget, vector<Asteroid>& asteroids) noexcept {
+  //Spawns asteroids until the budget runs out or the wave is over
+  int spawned = 0;
+  while (active_ && spawned < budget) {
+    if (!script_.next()) {
+      active_ = false;
+      break;
+    }
+    asteroids.push_back(script_.value());
+    spawned++;
+  }
+  return spawned;
+}
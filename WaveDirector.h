@@ -0,0 +1,160 @@
+#ifndef ASTEROIDS_WAVEDIRECTOR_H
+#define ASTEROIDS_WAVEDIRECTOR_H
+
+#include <coroutine>
+#include <exception>
+#include <random>
+#include <vector>
+
+#include "Asteroid.h"
+#include "SpawnPlacer.h"
+
+namespace asteroids {
+
+/**
+ * A coroutine which describes a wave of asteroids one at a time. Each
+ * co_yield hands out the next asteroid and suspends the script until the
+ * director has room for another one.
+ *
+ * @author Jai Aslam
+ */
+class WaveScript {
+public:
+  /** The state the compiler keeps for a running script */
+  struct promise_type {
+    /** The asteroid the script yielded last, alive while the script is suspended */
+    const Asteroid* current = nullptr;
+
+    WaveScript get_return_object() noexcept {
+      return WaveScript(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+
+    std::suspend_always yield_value(const Asteroid& ast) noexcept {
+      current = &ast;
+      return {};
+    }
+
+    void return_void() noexcept {}
+
+    /**
+    * Stops the program, since a script which throws has left its wave half
+    * spawned and the director has no way to report it.
+    */
+    [[noreturn]] void unhandled_exception() noexcept {
+      std::terminate();
+    }
+
+    /**
+    * Allocates the frame of a script, reusing the last frame freed on this
+    * thread when it is big enough, so starting a level does not allocate.
+    */
+    static void* operator new(/** The size of the frame */std::size_t size);
+
+    /**
+    * Frees the frame of a script, keeping one spare for the next script.
+    */
+    static void operator delete(/** The frame */void* frame, /** The size of the frame */std::size_t size) noexcept;
+  };
+
+  /**
+  * Constructs an empty script which has already finished.
+  */
+  WaveScript() noexcept = default;
+
+  /**
+  * Takes over the running script of another.
+  */
+  WaveScript(/** The script to take over */WaveScript&& other) noexcept;
+
+  /**
+  * Destroys this script and takes over the running script of another.
+  */
+  WaveScript& operator=(/** The script to take over */WaveScript&& other) noexcept;
+
+  /**
+  * Destroys the script, even if it has not finished.
+  */
+  ~WaveScript();
+
+  /**
+  * Runs the script until it yields its next asteroid.
+  *
+  * @returns false once the script has finished.
+  */
+  bool next() noexcept;
+
+  /**
+  * @returns the asteroid the script yielded last.
+  */
+  const Asteroid& value() const noexcept;
+
+private:
+  /** The running script, or null once there is nothing left to run */
+  std::coroutine_handle<promise_type> handle_;
+
+  /**
+  * Wraps the coroutine the compiler created.
+  */
+  explicit WaveScript(/** The coroutine */std::coroutine_handle<promise_type> handle) noexcept;
+};
+
+/**
+ * The script of a regular wave: the given number of asteroids of one size at
+ * random places on the screen, heading in random directions. Each asteroid
+ * is placed as it spawns, so it keeps clear of wherever the ship is then.
+ */
+WaveScript asteroidWave(/** The number of asteroids */int count, /** The radius of the asteroids */int radius, /** Picks where the asteroids appear */SpawnPlacer& placer, /** Picks the positions and directions */std::minstd_rand& random);
+
+/**
+ * Runs wave scripts a few asteroids per tick, so a new level fills the
+ * screen over several frames instead of spiking the one it starts in.
+ *
+ * @author Jai Aslam
+ */
+class WaveDirector {
+public:
+  /**
+  * Constructs a director with no wave running.
+  */
+  WaveDirector() noexcept;
+
+  /**
+  * Starts running a wave, abandoning whatever wave was running before.
+  */
+  void start(/** The script of the wave */WaveScript script) noexcept;
+
+  /**
+  * Abandons the running wave.
+  */
+  void stop() noexcept;
+
+  /**
+  * @returns whether a wave still has asteroids to spawn.
+  */
+  bool active() const noexcept;
+
+  /**
+  * Spawns the next asteroids of the running wave into the given asteroids.
+  *
+  * @returns the number of asteroids spawned.
+  */
+  int spawn(/** The most asteroids spawned this tick */int budget, /** The asteroids on the screen */std::vector<Asteroid>& asteroids) noexcept;
+
+private:
+  /** The wave being run */
+  WaveScript script_;
+
+  /** Whether the script still has asteroids to spawn */
+  bool active_ = false;
+};
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "AllocationTracker.h"
+#include "Game.h"
+#include "Check.h"
+
+using namespace std;
+using namespace asteroids;
+
+/** Holds on to what the tests allocate so the compiler cannot leave it out */
+static void* volatile keep = nullptr;
+
+/**
+ * Allocates an array of the given size and frees it again.
+ */
+static void allocate(/** The number of bytes */int bytes) {
+  char* memory = new char[bytes];
+  keep = memory;
+  delete[] memory;
+}
+
+/**
+ * Runs an autopilot game headless until it ends or the ticks run out.
+ *
+ * @returns the number of ticks which went over a budget of no allocations.
+ */
+static uint64_t overBudgetRunning(/** How the game runs */GameOptions options, /** The most ticks to run */int ticks) {
+  uint64_t before = AllocationTracker::overBudgetTicks();
+  Game game(640, 480, options);
+  for (int tick = 0; tick < ticks && game.stillAlive(); tick++) {
+    game.advance();
+  }
+  return AllocationTracker::overBudgetTicks() - before;
+}
+
+/**
+ * Tests the counting of allocations by phase and against the tick budget.
+ * Build: g++ -std=c++20 -pthread -rdynamic -DASTEROIDS_TRACK_ALLOCATIONS -I.
+ * tests/AllocationTrackerTest.cpp with every source but Main.cpp and
+ * MetricsReader.cpp, linked against SDL2, SDL2_ttf and SDL2_image.
+ *
+ * @return The status code. Normal is 0 and 1 is bad.
+ */
+int main() {
+  if (!AllocationTracker::kEnabled) {
+    cerr << "Allocations are only tracked with ASTEROIDS_TRACK_ALLOCATIONS defined" << endl;
+    return 1;
+  }
+
+  //An allocation counts against the phase the thread is in, and the phase
+  //goes back to the one before when the scope ends
+  AllocationTracker::Counts moveBefore = AllocationTracker::counts(AllocationTracker::PhaseMove);
+  AllocationTracker::Counts collideBefore = AllocationTracker::counts(AllocationTracker::PhaseCollide);
+  {
+    AllocationScope move(AllocationTracker::PhaseMove);
+    allocate(100);
+    {
+      AllocationScope collide(AllocationTracker::PhaseCollide);
+      allocate(10);
+    }
+    allocate(100);
+  }
+  allocate(1000);
+  AllocationTracker::Counts moveAfter = AllocationTracker::counts(AllocationTracker::PhaseMove);
+  AllocationTracker::Counts collideAfter = AllocationTracker::counts(AllocationTracker::PhaseCollide);
+  CHECK(moveAfter.allocations - moveBefore.allocations == 2);
+  CHECK(moveAfter.bytes - moveBefore.bytes == 200);
+  CHECK(collideAfter.allocations - collideBefore.allocations == 1);
+  CHECK(collideAfter.bytes - collideBefore.bytes == 10);
+
+  //Only the phases of a tick count against the budget, making room up front does not
+  AllocationTracker::setBudget(0);
+  AllocationTracker::beginTick();
+  allocate(10);
+  {
+    AllocationScope reserve(AllocationTracker::PhaseReserve);
+    allocate(10);
+  }
+  CHECK(AllocationTracker::endTick());
+  CHECK(AllocationTracker::overBudgetTicks() == 0);
+
+  AllocationTracker::beginTick();
+  {
+    AllocationScope spawn(AllocationTracker::PhaseSpawn);
+    allocate(10);
+    allocate(10);
+  }
+  CHECK(!AllocationTracker::endTick());
+  CHECK(AllocationTracker::overBudgetTicks() == 1);
+  CHECK(AllocationTracker::worstTick() == 2);
+
+  //The same tick is fine with a budget it fits in, or none at all
+  AllocationTracker::setBudget(2);
+  AllocationTracker::beginTick();
+  {
+    AllocationScope spawn(AllocationTracker::PhaseSpawn);
+    allocate(10);
+    allocate(10);
+  }
+  CHECK(AllocationTracker::endTick());
+  AllocationTracker::setBudget(-1);
+  AllocationTracker::beginTick();
+  {
+    AllocationScope spawn(AllocationTracker::PhaseSpawn);
+    allocate(10);
+    allocate(10);
+    allocate(10);
+  }
+  CHECK(AllocationTracker::endTick());
+  CHECK(AllocationTracker::overBudgetTicks() == 1);
+
+  //The report lists every phase and names where the allocations came from
+  ostringstream report;
+  AllocationTracker::report(report);
+  CHECK(report.str().find("reserve: ") != string::npos);
+  CHECK(report.str().find("1 ticks over budget") != string::npos);
+  CHECK(report.str().find("main+0x") != string::npos);
+
+  //A whole game allocates nothing once each level has made its room, with
+  //the schedule and the fleet as well
+  AllocationTracker::setBudget(0);
+  GameOptions options;
+  options.headless = true;
+  options.autopilot = true;
+  options.seed = 7;
+  CHECK(overBudgetRunning(options, 20000) == 0);
+  options.kineticCollisions = true;
+  options.fleetSize = 4;
+  CHECK(overBudgetRunning(options, 20000) == 0);
+  options.tickScale = 3;
+  CHECK(overBudgetRunning(options, 20000) == 0);
+
+  //The published statistics hold what the simulation allocated
+  Game game(640, 480, options);
+  game.advance();
+  CHECK(game.getTickStats().allocations > 0);
+  CHECK(game.getTickStats().allocations == AllocationTracker::simulationCounts().allocations);
+  CHECK(game.getTickStats().allocatedBytes == AllocationTracker::simulationCounts().bytes);
+
+  if (checkFailures > 0) {
+    return 1;
+  }
+  cout << "Allocation tracker tests passed" << endl;
+  return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef ASTEROIDS_TESTS_CHECK_H
+#define ASTEROIDS_TESTS_CHECK_H
+
+#include <iostream>
+
+namespace asteroids {
+
+/** The number of checks that failed so far */
+inline int checkFailures = 0;
+
+/**
+ * Reports a failed check without stopping, so one run shows every failure.
+ */
+inline void check(/** Whether the check passed */bool passed, /** The condition checked */const char* condition, /** The file it is in */const char* file, /** The line it is on */int line) {
+  if (!passed) {
+    std::cerr << file << ":" << line << ": check failed: " << condition << std::endl;
+    checkFailures++;
+  }
+}
+}
+
+/** Checks that the condition holds, printing it along with where it is if not */
+#define CHECK(condition) asteroids::check((condition), #condition, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "Environment.h"
+#include "Check.h"
+
+using namespace std;
+using namespace asteroids;
+
+/**
+ * The buffers one environment writes into.
+ */
+struct Buffers {
+  std::vector<float> entities;
+  std::vector<std::uint8_t> grid;
+  std::vector<float> rewards;
+  std::vector<std::uint8_t> dones;
+
+  /**
+  * Sizes the buffers for the environment and binds them to it.
+  */
+  explicit Buffers(/** The environment to write into them */VectorEnvironment& environment)
+    : entities(environment.size() * environment.entityStride()), grid(environment.size() * environment.gridWidth() * environment.gridHeight()),
+      rewards(environment.size()), dones(environment.size()) {
+    environment.bind(entities.data(), grid.data(), rewards.data(), dones.data());
+  }
+
+  /**
+  * @returns whether both hold exactly the same observations, rewards and done flags.
+  */
+  bool operator==(/** The other buffers */const Buffers& other) const {
+    return entities == other.entities && grid == other.grid && rewards == other.rewards && dones == other.dones;
+  }
+};
+
+/**
+ * @returns the allocations made so far outside of making room for a level,
+ * which steps only do when a game reaches a level bigger than any before.
+ */
+static std::uint64_t allocationsOutsideReserve() {
+  std::uint64_t total = 0;
+  for (int phase = 0; phase < AllocationTracker::kPhaseCount; phase++) {
+    if (phase != AllocationTracker::PhaseReserve) {
+      total += AllocationTracker::counts((AllocationTracker::Phase) phase).allocations;
+    }
+  }
+  return total;
+}
+
+/**
+ * Tests the batch of headless games used for training agents.
+ * Build: g++ -std=c++20 -pthread -I. tests/EnvironmentTest.cpp with every
+ * source but Main.cpp and MetricsReader.cpp, linked against SDL2, SDL2_ttf
+ * and SDL2_image. With -DASTEROIDS_TRACK_ALLOCATIONS it also checks that
+ * stepping allocates nothing.
+ *
+ * @return The status code. Normal is 0 and 1 is bad.
+ */
+int main() {
+  const int count = 3;
+  const int maxEntities = 32;
+  const int cellSize = 40;
+
+  //Two environments reset with the same seed play the same games
+  VectorEnvironment first(count, maxEntities, cellSize);
+  VectorEnvironment second(count, maxEntities, cellSize);
+  Buffers firstOut(first);
+  Buffers secondOut(second);
+  first.reset(11);
+  second.reset(11);
+  CHECK(firstOut == secondOut);
+  uint8_t actions[count];
+  bool same = true;
+  for (int tick = 0; tick < 500; tick++) {
+    for (int i = 0; i < count; i++) {
+      actions[i] = (tick * 7 + i * 3) % 32;
+    }
+    first.step(actions);
+    second.step(actions);
+    same = same && firstOut == secondOut;
+  }
+  CHECK(same);
+
+  //The first observation has the ship in the center, then the first
+  //asteroid, then padding, and each game's grid marks both
+  first.reset(11);
+  for (int i = 0; i < count; i++) {
+    const float* entities = firstOut.entities.data() + i * first.entityStride();
+    const Game& game = first.game(i);
+    CHECK(entities[0] == (float) EntityShip);
+    CHECK(entities[1] == 0.5f && entities[2] == 0.5f);
+    CHECK(entities[6] == (float) EntityAsteroid);
+    CHECK(entities[6 + 3] == 1.0f);
+    CHECK(entities[6 + 1] == game.getAsteroids()[0].getX() / 640.0f);
+    CHECK(entities[12] == (float) EntityNone);
+    CHECK(firstOut.rewards[i] == 0 && firstOut.dones[i] == 0);
+
+    const uint8_t* grid = firstOut.grid.data() + i * first.gridWidth() * first.gridHeight();
+    CHECK(grid[(240 / cellSize) * first.gridWidth() + 320 / cellSize] & OccupancyShip);
+    const Asteroid& ast = game.getAsteroids()[0];
+    CHECK(grid[(ast.getY() / cellSize) * first.gridWidth() + ast.getX() / cellSize] & OccupancyAsteroid);
+  }
+
+  //Rewards are the score each tick added, and a game that ends is flagged
+  //done and has already started over
+  bool rewarded = false;
+  bool rewardsMatch = true;
+  bool ended = false;
+  std::uint64_t allocationsBefore = allocationsOutsideReserve();
+  for (int tick = 0; tick < 200000 && !ended; tick++) {
+    int scores[count];
+    for (int i = 0; i < count; i++) {
+      scores[i] = first.game(i).getScore();
+      actions[i] = i == 0 ? 0 : ActionFire | ActionRotateLeft;
+    }
+    first.step(actions);
+    for (int i = 0; i < count; i++) {
+      if (firstOut.dones[i]) {
+        ended = true;
+        CHECK(first.game(i).getScore() == 0);
+        CHECK(first.game(i).getLives() == 3);
+        CHECK(firstOut.entities[i * first.entityStride() + 1] == 0.5f);
+      }
+      else {
+        rewardsMatch = rewardsMatch && firstOut.rewards[i] == first.game(i).getScore() - scores[i];
+      }
+      rewarded = rewarded || firstOut.rewards[i] > 0;
+    }
+  }
+  CHECK(rewarded);
+  CHECK(rewardsMatch);
+  CHECK(ended);
+
+  //Stepping, resets included, never allocates
+  if (AllocationTracker::kEnabled) {
+    CHECK(allocationsOutsideReserve() == allocationsBefore);
+  }
+
+  if (checkFailures > 0) {
+    return 1;
+  }
+  cout << "Environment tests passed" << endl;
+  return 0;
+}
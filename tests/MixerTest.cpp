@@ -0,0 +1,89 @@
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Mixer.h"
+#include "Check.h"
+
+using namespace std;
+using namespace asteroids;
+
+/**
+ * Tests the mixer without speakers using SDL's disk audio driver, which
+ * plays into a file instead of a sound card.
+ * Build: g++ -std=c++20 -pthread -I. tests/MixerTest.cpp Mixer.cpp -lSDL2
+ *
+ * @return The status code. Normal is 0 and 1 is bad.
+ */
+int main() {
+  //A mixer that was never opened drops every sound and mixes silence
+  {
+    Mixer mixer;
+    mixer.play(SoundExplosion);
+    int16_t out[256];
+    memset(out, 0x7f, sizeof(out));
+    mixer.mix(out, 256);
+    bool silent = true;
+    for (int16_t sample : out) {
+      silent = silent && sample == 0;
+    }
+    CHECK(silent);
+  }
+
+  //Plays into a file, which the disk driver fills in real time
+  string path = "mixer_test_" + to_string(SDL_GetTicks()) + ".raw";
+  setenv("SDL_AUDIODRIVER", "disk", 1);
+  setenv("SDL_DISKAUDIOFILE", path.c_str(), 1);
+  setenv("SDL_DISKAUDIODELAY", "1", 1);
+  if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+    cerr << "Unable to start the disk audio driver: " << SDL_GetError() << endl;
+    return 1;
+  }
+  CHECK(strcmp(SDL_GetCurrentAudioDriver(), "disk") == 0);
+
+  {
+    Mixer mixer;
+    CHECK(mixer.open());
+    CHECK(mixer.getFrequency() > 0);
+
+    //Every sound plays at once, then there is time for them to be written out
+    mixer.play(SoundFire);
+    mixer.play(SoundExplosion, 128);
+    mixer.play(SoundThrust);
+    SDL_Delay(700);
+
+    //Closing twice is harmless and sounds asked for afterwards are dropped
+    mixer.close();
+    mixer.close();
+    mixer.play(SoundFire);
+  }
+  SDL_Quit();
+
+  //The file holds 16 bit mono samples, some of which are not silent
+  vector<int16_t> samples;
+  if (FILE* file = fopen(path.c_str(), "rb")) {
+    int16_t buffer[512];
+    size_t read;
+    while ((read = fread(buffer, sizeof(int16_t), 512, file)) > 0) {
+      samples.insert(samples.end(), buffer, buffer + read);
+    }
+    fclose(file);
+  }
+  remove(path.c_str());
+  int loud = 0;
+  for (int16_t sample : samples) {
+    loud += sample != 0;
+  }
+  CHECK(!samples.empty());
+  CHECK(loud > 0);
+
+  if (checkFailures > 0) {
+    return 1;
+  }
+  cout << "Mixer tests passed" << endl;
+  return 0;
+}
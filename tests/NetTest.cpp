@@ -0,0 +1,168 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "Game.h"
+#include "NetState.h"
+#include "NetServer.h"
+#include "NetClient.h"
+#include "UdpSocket.h"
+#include "Check.h"
+
+using namespace std;
+using namespace asteroids;
+
+/**
+ * @returns whether the two states hold the same game.
+ */
+static bool sameState(/** One state */const NetState& a, /** The other state */const NetState& b) {
+  if (a.shipX != b.shipX || a.shipY != b.shipY || a.shipAngle != b.shipAngle || a.score != b.score || a.lives != b.lives || a.level != b.level) {
+    return false;
+  }
+  if (a.asteroids.size() != b.asteroids.size() || a.bullets.size() != b.bullets.size()) {
+    return false;
+  }
+  for (unsigned i = 0; i < a.asteroids.size(); i++) {
+    const NetState::Rock& x = a.asteroids[i];
+    const NetState::Rock& y = b.asteroids[i];
+    if (x.x != y.x || x.y != y.y || x.radius != y.radius || x.direction != y.direction) {
+      return false;
+    }
+  }
+  for (unsigned i = 0; i < a.bullets.size(); i++) {
+    const NetState::Shot& x = a.bullets[i];
+    const NetState::Shot& y = b.bullets[i];
+    if (x.x != y.x || x.y != y.y || x.direction != y.direction) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Encodes the state against the baseline and decodes it again.
+ *
+ * @returns whether what was decoded is what the encoder said was sent.
+ */
+static bool roundTrip(/** The state to send */const NetState& state, /** The state the client has */const NetState& baseline, /** Receives what was sent */NetState& sent) {
+  uint8_t packet[kMaxPacketBytes];
+  BitWriter out(packet, kMaxPacketBytes);
+  state.encode(baseline, out, kMaxPacketBytes * 8, sent);
+  BitReader in(packet, out.size());
+  NetState decoded;
+  return decoded.decode(in, baseline) && sameState(decoded, sent);
+}
+
+/**
+ * Tests the snapshot encoding and a server and client talking over loopback.
+ * Build: g++ -std=c++20 -pthread -I. tests/NetTest.cpp with every source but
+ * Main.cpp and MetricsReader.cpp, linked against SDL2, SDL2_ttf and SDL2_image.
+ *
+ * @return The status code. Normal is 0 and 1 is bad.
+ */
+int main() {
+  GameOptions options;
+  options.headless = true;
+  options.autopilot = true;
+  options.seed = 5;
+  Game game(640, 480, options);
+
+  //A whole state, then the next one sent as the difference from it
+  NetState first;
+  first.capture(game, 1);
+  const NetState empty;
+  NetState firstSent;
+  CHECK(roundTrip(first, empty, firstSent));
+  CHECK(sameState(first, firstSent));
+  for (int i = 0; i < 5; i++) {
+    game.advance();
+  }
+  NetState second;
+  second.capture(game, 6);
+  NetState secondSent;
+  CHECK(roundTrip(second, firstSent, secondSent));
+  CHECK(sameState(second, secondSent));
+
+  //A state too large for the budget is cut short the same way on both sides
+  NetState crowded = second;
+  crowded.asteroids.assign(2000, NetState::Rock{320, 240, 50, 3});
+  NetState crowdedSent;
+  CHECK(roundTrip(crowded, empty, crowdedSent));
+  CHECK(crowdedSent.asteroids.size() < crowded.asteroids.size());
+
+  //The server hears from the client, then sends it the game every tick
+  NetServer server(0);
+  NetClient client("127.0.0.1", server.port());
+  bool received = false;
+  for (int tick = 0; tick < 200 && client.statesReceived() < 10; tick++) {
+    client.send(0);
+    server.receive(game);
+    game.advance();
+    server.broadcast(game);
+    this_thread::sleep_for(chrono::milliseconds(2));
+    received = client.receive() || received;
+  }
+  CHECK(received);
+  CHECK(server.stats().clients == 1);
+  CHECK(client.statesReceived() >= 10);
+
+  //The client draws the game the server has
+  FrameSnapshot snapshot(0);
+  CHECK(client.interpolate(snapshot));
+  CHECK(snapshot.score == game.getScore());
+  CHECK(snapshot.asteroids.size() == game.getAsteroids().size());
+
+  //A snapshot from far in the future sent by anyone but the server is
+  //ignored, so it cannot make the client drop every real one after it
+  {
+    UdpSocket spoofer(0);
+    uint8_t packet[kMaxPacketBytes];
+    BitWriter out(packet, kMaxPacketBytes);
+    out.write(kNetMagic, 16);
+    out.write(PacketSnapshot, 8);
+    out.write(0xFFFFFFFF, 32);
+    out.write(0, 32);
+    NetState sent;
+    first.encode(empty, out, kMaxPacketBytes * 8, sent);
+    spoofer.send(UdpSocket::address("127.0.0.1", client.port()), packet, out.size());
+  }
+  this_thread::sleep_for(chrono::milliseconds(10));
+  client.receive();
+  uint64_t before = client.statesReceived();
+  for (int tick = 0; tick < 50; tick++) {
+    client.send(0);
+    server.receive(game);
+    game.advance();
+    server.broadcast(game);
+    this_thread::sleep_for(chrono::milliseconds(2));
+    client.receive();
+  }
+  CHECK(client.statesReceived() > before);
+
+  //Only a well formed input packet connects a client, so strangers saying
+  //goodbye or sending cut off input take no place on the server
+  {
+    UdpSocket stranger(0);
+    uint8_t packet[kMaxPacketBytes];
+    BitWriter bye(packet, kMaxPacketBytes);
+    bye.write(kNetMagic, 16);
+    bye.write(PacketBye, 8);
+    stranger.send(UdpSocket::address("127.0.0.1", server.port()), packet, bye.size());
+    BitWriter cut(packet, kMaxPacketBytes);
+    cut.write(kNetMagic, 16);
+    cut.write(PacketInput, 8);
+    cut.write(1, 16);
+    stranger.send(UdpSocket::address("127.0.0.1", server.port()), packet, cut.size());
+    this_thread::sleep_for(chrono::milliseconds(10));
+    server.receive(game);
+    server.broadcast(game);
+  }
+  CHECK(server.stats().clients == 1);
+
+  if (checkFailures > 0) {
+    return 1;
+  }
+  cout << "Network tests passed" << endl;
+  return 0;
+}